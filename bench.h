@@ -1,7 +1,15 @@
+#ifndef BENCH_H
+#define BENCH_H
+
 #include <cstdint>
 #include <chrono>
 #include <stdio.h>
 #include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
 
 namespace mtl {
 
@@ -9,7 +17,7 @@ struct alignas(64) Count {
     std::atomic<size_t> data;
 };
 
-static Count counters[512];
+inline Count counters[512];
 
 template<typename P>
 void bench(P pred, const char *msg, size_t times = 1000) {
@@ -26,4 +34,101 @@ void bench(P pred, const char *msg, size_t times = 1000) {
     fprintf(stderr, "%s took: %ldms\n", msg, diff);
 }
 
+// throughput in operations per second, latencies in nanoseconds
+struct Stat {
+    double ops;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+};
+
+inline void pin(unsigned i) {
+    cpu_set_t set;
+    unsigned n = std::thread::hardware_concurrency();
+    CPU_ZERO(&set);
+    CPU_SET(n ? i % n : 0, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// runs `np` threads calling `prod(i)` and `nc` threads calling `cons(i)`,
+// `times` each, `i` being the thread's index, every thread pinned to its own
+// cpu and released together, timing every call
+template<typename P, typename C>
+Stat mtbench(P prod, C cons, unsigned np, unsigned nc, const char *msg,
+             size_t times = 100000) {
+    using namespace std::chrono;
+    using clk = steady_clock;
+    unsigned n = np + nc;
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::vector<uint64_t>> lat(n);
+    std::vector<std::thread> thrs;
+    clk::time_point beg, end;
+    for (unsigned t = 0; t < n; ++t) {
+        thrs.emplace_back([&, t] {
+            auto &l = lat[t];
+            pin(t);
+            l.reserve(times);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                continue;
+            }
+            for (size_t i = 0; i < times; ++i) {
+                auto b = clk::now();
+                if (t < np) {
+                    prod(t);
+                } else {
+                    cons(t);
+                }
+                asm volatile("" : : : "memory");
+                l.push_back(duration_cast<nanoseconds>(clk::now() - b).count());
+            }
+        });
+    }
+    while (ready.load() != n) {
+        continue;
+    }
+    beg = clk::now();
+    go.store(true, std::memory_order_release);
+    for (auto &t : thrs) {
+        t.join();
+    }
+    end = clk::now();
+    std::vector<uint64_t> all;
+    all.reserve(n * times);
+    for (auto &l : lat) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    auto pct = [&](double p) -> uint64_t {
+        if (all.empty()) {
+            return 0;
+        }
+        auto at = all.begin() + (size_t)(p * (all.size() - 1));
+        std::nth_element(all.begin(), at, all.end());
+        return *at;
+    };
+    Stat res;
+    res.ops = all.size() / duration_cast<duration<double>>(end - beg).count();
+    res.p50 = pct(0.5);
+    res.p99 = pct(0.99);
+    res.p999 = pct(0.999);
+    fprintf(stderr,
+            "%s %u+%u threads: %.0f ops/s, p50 %luns, p99 %luns, "
+            "p99.9 %luns\n",
+            msg, np, nc, res.ops, res.p50, res.p99, res.p999);
+    return res;
+}
+
+// scaling curve, runs `mtbench` doubling the threads from 2 up to `max`,
+// half producers and half consumers
+template<typename P, typename C>
+void sweep(P prod, C cons, unsigned max, const char *msg,
+           size_t times = 100000) {
+    for (unsigned n = 2; n <= max; n *= 2) {
+        mtbench(prod, cons, n / 2, n - n / 2, msg, times);
+    }
+}
+
 }
+
+#endif // BENCH_H
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+
+namespace mtl {
+
+namespace mem {
+
+// Allocation policies of the containers, `Libc` uses malloc and free, `Bump`
+// carves from the thread's current `Arena`, so that the containers built in
+// it are freed all together, by resetting it.
+// `ralloc` takes the old and the new number of bytes, `dalloc` is a no-op for
+// `Bump`, and `usable` returns how many bytes of an `n` bytes allocation can be
+// used.
+
+struct Libc {
+    static void *alloc(const size_t n) { return malloc(n); }
+    static void *zalloc(const size_t n) { return calloc(n, 1); }
+    static void *ralloc(void *raw, const size_t, const size_t n) {
+        return realloc(raw, n);
+    }
+    static void dalloc(void *raw) { free(raw); }
+    static size_t usable(void *raw, const size_t) {
+        return malloc_usable_size(raw);
+    }
+};
+
+// list of chunks, kept on reset, `bump` and `end` delimit the free space of
+// `curr`
+struct Chunk {
+    Chunk *next;
+    size_t size;
+};
+struct Arena {
+    Chunk *chunks = nullptr;
+    Chunk *curr = nullptr;
+    char *bump = nullptr;
+    char *end = nullptr;
+    char *last = nullptr;
+    size_t chunksz = 1 << 20;
+};
+inline void init(Arena &a) {
+    a.chunks = nullptr;
+    a.curr = nullptr;
+    a.bump = nullptr;
+    a.end = nullptr;
+    a.last = nullptr;
+    a.chunksz = 1 << 20;
+}
+inline bool make(Arena &a, const size_t chunksz) {
+    init(a);
+    a.chunksz = chunksz;
+    return true;
+}
+// starts over from the first chunk, in constant time
+inline void reset(Arena &a) {
+    a.curr = a.chunks;
+    a.bump = a.curr ? (char *)(a.curr + 1) : nullptr;
+    a.end = a.curr ? a.bump + a.curr->size : nullptr;
+    a.last = nullptr;
+}
+inline void del(Arena &a) {
+    Chunk *next;
+    for (Chunk *c = a.chunks; c != nullptr; c = next) {
+        next = c->next;
+        free(c);
+    }
+    init(a);
+}
+// moves to the next chunk that fits `n` bytes, allocating it if needed,
+// smaller chunks are skipped until the next reset
+inline bool grow(Arena &a, const size_t n) {
+    Chunk *next = a.curr ? a.curr->next : a.chunks;
+    while (next != nullptr && next->size < n) {
+        next = next->next;
+    }
+    if (next == nullptr) {
+        size_t size = n > a.chunksz ? n : a.chunksz;
+        if ((next = (Chunk *)malloc(sizeof(Chunk) + size)) == nullptr) {
+            return false;
+        }
+        next->size = size;
+        if (a.curr == nullptr) {
+            next->next = a.chunks;
+            a.chunks = next;
+        } else {
+            next->next = a.curr->next;
+            a.curr->next = next;
+        }
+    }
+    a.curr = next;
+    a.bump = (char *)(next + 1);
+    a.end = a.bump + next->size;
+    return true;
+}
+// the arena `Bump` allocates from, per thread
+inline Arena *&arena() {
+    static thread_local Arena *a = nullptr;
+    return a;
+}
+// sets the thread's arena, returning the previous one
+inline Arena *use(Arena *a) {
+    Arena *prev = arena();
+    arena() = a;
+    return prev;
+}
+
+struct Bump {
+    static constexpr size_t align = 16;
+    // fails on the threads without an arena
+    static void *alloc(const size_t n) {
+        if (arena() == nullptr) {
+            return nullptr;
+        }
+        Arena &a = *arena();
+        size_t size = (n + align - 1) & ~(align - 1);
+        if ((size_t)(a.end - a.bump) < size && grow(a, size) == false) {
+            return nullptr;
+        }
+        a.last = a.bump;
+        a.bump += size;
+        return a.last;
+    }
+    static void *zalloc(const size_t n) {
+        void *res = alloc(n);
+        if (res != nullptr) {
+            memset(res, 0, n);
+        }
+        return res;
+    }
+    // the last allocation grows in place, shrinking never moves
+    static void *ralloc(void *raw, const size_t os, const size_t ns) {
+        void *res;
+        if (raw == nullptr) {
+            return alloc(ns);
+        }
+        if (ns <= os) {
+            return raw;
+        }
+        if (arena() == nullptr) {
+            return nullptr;
+        }
+        Arena &a = *arena();
+        size_t size = (ns + align - 1) & ~(align - 1);
+        if (raw == a.last && (size_t)(a.end - a.last) >= size) {
+            a.bump = a.last + size;
+            return raw;
+        }
+        if ((res = alloc(ns)) != nullptr) {
+            memcpy(res, raw, os);
+        }
+        return res;
+    }
+    static void dalloc(void *) {}
+    static size_t usable(void *, const size_t n) { return n; }
+};
+}
+}
@@ -13,6 +13,9 @@ template<typename T> concept bool Del     = requires(T d) {
 template<typename T> concept bool Init    = requires(T d) {
     { init(d)       } -> void
 };
+template<typename T> concept bool BulkInit = requires(T *d, size_t n) {
+    { init(d, n)    } -> void
+};
 template<typename T> concept bool At      = requires(T cont, size_t i) {
     { cont[i]       } -> auto
 };
@@ -27,6 +30,7 @@ requires(T c) {
 template<typename T> concept bool NoReloc = !Reloc<T>;
 template<typename T> concept bool NoDel   = !Del<T>;
 template<typename T> concept bool NoInit  = !Init<T>;
+template<typename T> concept bool NoBulkInit = !BulkInit<T>;
 template<typename T> concept bool NoAt    = !At<T>;
 template<typename T> concept bool NoCopy  = !Copy<T>;
 template<typename T> concept bool NoOwner = !Owner<T>;
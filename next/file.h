@@ -0,0 +1,118 @@
+#pragma once
+
+#include "com.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <assert.h>
+#include <type_traits>
+
+namespace mtl {
+
+// Fixed size vector mapping a file, `ro` maps it read only, `cow` privately,
+// the writes never reaching the file, and `rw` shares it, the writes reaching
+// it on `sync` or `del`.
+namespace file {
+enum Mode : unsigned { ro, cow, rw };
+}
+
+template <typename T> struct FileVec {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "must be trivially copyable");
+    using Owned = T;
+    size_t size = 0;
+    T *data = nullptr;
+    int fd = -1;
+    file::Mode mode = file::ro;
+    T &operator[](const size_t i) {
+        assert(i < size);
+        return data[i];
+    }
+};
+void init(FileVec<auto> &vec) {
+    vec.size = 0;
+    vec.data = nullptr;
+    vec.fd = -1;
+    vec.mode = file::ro;
+}
+namespace mem {
+// maps the `size` elements of `vec.fd` as `vec.mode` asks
+template <typename T> bool fmap(FileVec<T> &vec, const size_t size) {
+    void *res;
+    int prot = vec.mode == file::ro ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = vec.mode == file::rw ? MAP_SHARED : MAP_PRIVATE;
+    vec.size = size;
+    if (size == 0) {
+        return true;
+    }
+    res = mmap(nullptr, size * sizeof(T), prot, flags, vec.fd, 0);
+    if (res == MAP_FAILED) {
+        close(vec.fd);
+        init(vec);
+        return false;
+    }
+    vec.data = (T *)res;
+    return true;
+}
+}
+// maps the file at `path`, its size rounded down to whole elements
+template <typename T>
+bool open(FileVec<T> &vec, const char *path, const file::Mode mode) {
+    struct stat st;
+    if (vec.data != nullptr || vec.fd != -1) {
+        return false;
+    }
+    if ((vec.fd = ::open(path, mode == file::rw ? O_RDWR : O_RDONLY)) < 0) {
+        vec.fd = -1;
+        return false;
+    }
+    if (fstat(vec.fd, &st) != 0) {
+        close(vec.fd);
+        init(vec);
+        return false;
+    }
+    vec.mode = mode;
+    return mem::fmap(vec, (size_t)st.st_size / sizeof(T));
+}
+// creates, or truncates, the file at `path` to `size` zeroed elements, and
+// maps it writable, to build it
+template <typename T>
+bool make(FileVec<T> &vec, const char *path, const size_t size) {
+    if (vec.data != nullptr || vec.fd != -1) {
+        return false;
+    }
+    if ((vec.fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+        vec.fd = -1;
+        return false;
+    }
+    if (ftruncate(vec.fd, size * sizeof(T)) != 0) {
+        close(vec.fd);
+        init(vec);
+        return false;
+    }
+    vec.mode = file::rw;
+    return mem::fmap(vec, size);
+}
+// writes the changes back to the file, waiting for them unless `async`
+bool sync(FileVec<auto> &vec, const bool async = false) {
+    if (vec.mode != file::rw) {
+        return false;
+    }
+    if (vec.size == 0) {
+        return true;
+    }
+    return msync(vec.data, vec.size * sizeof(*vec.data),
+                 async ? MS_ASYNC : MS_SYNC) == 0;
+}
+void del(FileVec<auto> &vec) {
+    if (vec.data != nullptr) {
+        munmap(vec.data, vec.size * sizeof(*vec.data));
+    }
+    if (vec.fd != -1) {
+        close(vec.fd);
+    }
+    init(vec);
+}
+}
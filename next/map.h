@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mtl {
+
+namespace mem {
+
+// Allocation policy for very large containers, each allocation is its own
+// anonymous mapping, grown with mremap, so that the kernel moves the pages
+// instead of copying them. `Huge` also asks for transparent huge pages, and
+// rounds the mappings to their size.
+// The mapping size is kept in a header, one cache line before the data.
+template <bool Huge> struct Mapped {
+    static constexpr size_t head = 64;
+    static constexpr size_t hpage = 1 << 21;
+    static size_t round(const size_t n) {
+        size_t page = Huge ? hpage : (size_t)sysconf(_SC_PAGESIZE);
+        return (n + head + page - 1) & ~(page - 1);
+    }
+    static char *base(void *raw) { return (char *)raw - head; }
+    static void *alloc(const size_t n) {
+        size_t size = round(n);
+        void *res = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (res == MAP_FAILED) {
+            return nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        if (Huge) {
+            madvise(res, size, MADV_HUGEPAGE);
+        }
+#endif
+        *(size_t *)res = size;
+        return (char *)res + head;
+    }
+    // fresh anonymous pages are zeroed
+    static void *zalloc(const size_t n) { return alloc(n); }
+    static void *ralloc(void *raw, const size_t, const size_t n) {
+        if (raw == nullptr) {
+            return alloc(n);
+        }
+        size_t os = *(size_t *)base(raw);
+        size_t ns = round(n);
+        if (ns <= os) {
+            return raw;
+        }
+        void *res = mremap(base(raw), os, ns, MREMAP_MAYMOVE);
+        if (res == MAP_FAILED) {
+            return nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        if (Huge) {
+            madvise(res, ns, MADV_HUGEPAGE);
+        }
+#endif
+        *(size_t *)res = ns;
+        return (char *)res + head;
+    }
+    static void dalloc(void *raw) {
+        if (raw != nullptr) {
+            munmap(base(raw), *(size_t *)base(raw));
+        }
+    }
+    static size_t usable(void *raw, const size_t) {
+        return *(size_t *)base(raw) - head;
+    }
+};
+using Map = Mapped<false>;
+using HugeMap = Mapped<true>;
+}
+}
@@ -5,35 +5,36 @@
 
 namespace mtl {
 
-template<typename T> struct Own {
+template<typename T, typename A = mem::Libc> struct Own {
     using Owned = T;
+    using Alloc = A;
     T* data;
 };
-void init(Own<auto>& d) {
+void init(Own<auto, auto>& d) {
     d.data = nullptr;
 }
-void del(Own<NoDel>& d) {
-    free(d.data);
+template<NoDel T, typename A> void del(Own<T, A>& d) {
+    mem::dalloc<A>(d.data);
 }
-void del(Own<Del>& d) {
+template<Del T, typename A> void del(Own<T, A>& d) {
     del(d->data);
-    free(d.data);
+    mem::dalloc<A>(d.data);
 }
-template<Init T> bool make(Own<T>& d) {
-    if ((d.data = mem::ualloc<T>(1)) == nullptr) {
+template<Init T, typename A> bool make(Own<T, A>& d) {
+    if ((d.data = mem::ualloc<T, A>(1)) == nullptr) {
         return false;
     }
     init(*d.data);
     return true;
 }
-template<typename T> bool make(Own<T>& d, const T& ele) {
-    if ((d.data = mem::ealloc<T>(ele, 1)) == nullptr) {
+template<typename T, typename A> bool make(Own<T, A>& d, const T& ele) {
+    if ((d.data = mem::ealloc<T, A>(ele, 1)) == nullptr) {
         return false;
     }
     return true;
 }
 
-auto getnnull(Own<auto>& d) {
+auto getnnull(Own<auto, auto>& d) {
     return *d.data;
 }
 
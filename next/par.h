@@ -0,0 +1,254 @@
+#pragma once
+
+#include "com.h"
+#include "vec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace mtl {
+
+// Parallel versions of `copy`, `merge` and `resize`, the range is split in
+// chunks of `grain` bytes, taken in order by the pool's workers and by the
+// calling thread. Ranges under `serial` bytes stay on the calling thread.
+// The element hooks run on the workers, so they can't allocate from the
+// caller's `Arena`.
+namespace par {
+
+using Task = void (*)(void *, size_t, size_t);
+
+struct Pool {
+    std::thread *workers = nullptr;
+    unsigned nworkers = 0;
+    size_t serial = 1 << 20;
+    size_t grain = 1 << 18;
+    // a job at a time
+    std::mutex job;
+    std::mutex mtx;
+    std::condition_variable start;
+    std::condition_variable done;
+    uint64_t gen = 0;
+    unsigned busy = 0;
+    bool stop = false;
+    Task task = nullptr;
+    void *ctx = nullptr;
+    size_t size = 0;
+    size_t chunk = 0;
+    std::atomic<size_t> next{0};
+};
+
+inline void steal(Pool &p) {
+    size_t lo;
+    while ((lo = p.next.fetch_add(p.chunk, std::memory_order_relaxed)) <
+           p.size) {
+        p.task(p.ctx, lo, lo + p.chunk < p.size ? lo + p.chunk : p.size);
+    }
+}
+inline void work(Pool &p) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> l(p.mtx);
+            p.start.wait(l, [&] { return p.stop || p.gen != seen; });
+            if (p.stop) {
+                return;
+            }
+            seen = p.gen;
+        }
+        steal(p);
+        std::lock_guard<std::mutex> l(p.mtx);
+        if (--p.busy == 0) {
+            p.done.notify_one();
+        }
+    }
+}
+inline bool make(Pool &p, const unsigned nworkers) {
+    if ((p.workers = new (std::nothrow) std::thread[nworkers]) == nullptr) {
+        return false;
+    }
+    for (p.nworkers = 0; p.nworkers < nworkers; ++p.nworkers) {
+        p.workers[p.nworkers] = std::thread(work, std::ref(p));
+    }
+    return true;
+}
+inline void del(Pool &p) {
+    {
+        std::lock_guard<std::mutex> l(p.mtx);
+        p.stop = true;
+    }
+    p.start.notify_all();
+    for (unsigned i = 0; i < p.nworkers; ++i) {
+        p.workers[i].join();
+    }
+    delete[] p.workers;
+    p.workers = nullptr;
+    p.nworkers = 0;
+}
+// the default pool, a worker per other hardware thread, never deleted, as
+// workers might still wait on it at exit
+inline Pool &pool() {
+    static Pool *p = [] {
+        Pool *res = new Pool;
+        unsigned n = std::thread::hardware_concurrency();
+        make(*res, n > 1 ? n - 1 : 0);
+        return res;
+    }();
+    return *p;
+}
+// runs `f(lo, hi)` over the chunks of `chunk` indices of `[0, size)` on
+// all the workers, returns once all are done
+template <typename F>
+void run(Pool &p, const size_t size, const size_t chunk, F f) {
+    std::lock_guard<std::mutex> job(p.job);
+    {
+        std::lock_guard<std::mutex> l(p.mtx);
+        p.task = [](void *ctx, size_t lo, size_t hi) { (*(F *)ctx)(lo, hi); };
+        p.ctx = &f;
+        p.size = size;
+        p.chunk = chunk;
+        p.next.store(0, std::memory_order_relaxed);
+        p.busy = p.nworkers;
+        ++p.gen;
+    }
+    p.start.notify_all();
+    steal(p);
+    std::unique_lock<std::mutex> l(p.mtx);
+    p.done.wait(l, [&] { return p.busy == 0; });
+}
+// runs `f(lo, hi)` over the chunks of `[0, size)`, elements being `esize`
+// bytes
+template <typename F>
+void each(Pool &p, const size_t size, const size_t esize, F f) {
+    if (p.nworkers == 0 || size * esize < p.serial) {
+        f(size_t(0), size);
+        return;
+    }
+    run(p, size, p.grain > esize ? p.grain / esize : 1, f);
+}
+// runs `f(i)` for each of the `n` tasks, whatever their size
+template <typename F> void tasks(Pool &p, const size_t n, F f) {
+    auto g = [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            f(i);
+        }
+    };
+    if (p.nworkers == 0) {
+        g(0, n);
+        return;
+    }
+    run(p, n, 1, g);
+}
+}
+
+// on failure, `dst` keeps the elements before the first one that failed, the
+// ones copied after it by other chunks are deleted, `ends` holding where each
+// chunk stopped
+template <DnCont T, DnCont U>
+bool pcopy(T &dst, U &src, par::Pool &p = par::pool()) requires
+    Copy<typename U::Owned> {
+    using E = typename U::Owned;
+    constexpr auto relaxed = std::memory_order_relaxed;
+    std::atomic<size_t> fail{src.size};
+    size_t chunk = p.grain > sizeof(E) ? p.grain / sizeof(E) : 1;
+    size_t nchunks = src.size / chunk + 1;
+    size_t *ends;
+    cutoff(dst, 0);
+    if (reserve(dst, src.size) == false) {
+        return false;
+    }
+    if ((ends = mem::zalloc<size_t>(nchunks)) == nullptr) {
+        return false;
+    }
+    par::each(p, src.size, sizeof(E), [&](size_t lo, size_t hi) {
+        size_t i = lo;
+        size_t f;
+        for (; i < hi && i < fail.load(relaxed); ++i) {
+            init(dst.data[i]);
+            if (copy(dst.data[i], src.data[i]) == false) {
+                if constexpr (Del<E>) {
+                    del(dst.data[i]);
+                }
+                break;
+            }
+        }
+        ends[lo / chunk] = i;
+        f = fail.load(relaxed);
+        while (i < hi && i < f &&
+               !fail.compare_exchange_weak(f, i, relaxed)) {
+            continue;
+        }
+    });
+    dst.size = fail.load(relaxed);
+    if constexpr (Del<E>) {
+        for (size_t k = 0; k < nchunks && dst.size < src.size; ++k) {
+            for (size_t i = std::max(k * chunk, dst.size); i < ends[k]; ++i) {
+                del(dst.data[i]);
+            }
+        }
+    }
+    mem::dalloc(ends);
+    return dst.size == src.size;
+}
+template <DnCont T, DnCont U>
+bool pcopy(T &dst, U &src, par::Pool &p = par::pool()) requires
+    NoCopy<typename U::Owned> {
+    cutoff(dst, 0);
+    if (reserve(dst, src.size) == false) {
+        return false;
+    }
+    par::each(p, src.size, sizeof(typename U::Owned),
+              [&](size_t lo, size_t hi) {
+                  mem::cpy(dst.data + lo, src.data + lo, hi - lo);
+              });
+    dst.size = src.size;
+    return true;
+}
+template <DnCont T, DnCont U>
+bool pmerge(T &dst, U &src, par::Pool &p = par::pool()) {
+    size_t ns = dst.size + src.size;
+    if (reserve(dst, ns) == false) {
+        return false;
+    }
+    par::each(p, src.size, sizeof(typename U::Owned),
+              [&](size_t lo, size_t hi) {
+                  mem::cpy(dst.data + dst.size + lo, src.data + lo, hi - lo);
+              });
+    src.size = 0;
+    dst.size = ns;
+    return true;
+}
+DnCont { T }
+bool presize(T &vec, const size_t n, const typename T::Owned &ele,
+             par::Pool &p = par::pool()) requires NoReloc<typename T::Owned> {
+    if (vec.size >= n) {
+        return resize(vec, n, ele);
+    }
+    if (reserve(vec, n) == false) {
+        return false;
+    }
+    par::each(p, n - vec.size, sizeof(ele), [&](size_t lo, size_t hi) {
+        mem::efill(vec.data + vec.size + lo, ele, hi - lo);
+    });
+    vec.size = n;
+    return true;
+}
+DnCont { T }
+bool presize(T &vec, const size_t n,
+             par::Pool &p = par::pool()) requires Init<typename T::Owned> {
+    if (vec.size >= n) {
+        return resize(vec, n);
+    }
+    if (reserve(vec, n) == false) {
+        return false;
+    }
+    par::each(p, n - vec.size, sizeof(typename T::Owned),
+              [&](size_t lo, size_t hi) {
+                  mem::einit(vec.data + vec.size + lo, hi - lo);
+              });
+    vec.size = n;
+    return true;
+}
+}
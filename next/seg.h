@@ -0,0 +1,204 @@
+#pragma once
+
+#include "com.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <assert.h>
+#include <atomic>
+
+namespace mtl {
+
+// Concurrent vector of segments that never move, the `k`-th one holding
+// `B << k` elements, so that the addresses of the elements are stable.
+// Writers claim their slots by adding to `size`, installing the segments they
+// reach with a compare and swap, and publish each element through its slot's
+// ready flag, kept after the elements of the segment; `size` counts the
+// claimed slots, so it bounds the indexes, and `at` returns nullptr for the
+// slots not published yet.
+// A failed segment allocation or copy leaves the claimed slots unpublished,
+// and they're never read nor deleted.
+namespace seg {
+// the segment of index `i`, and the index in the segment
+template <size_t B> void locate(const size_t i, unsigned &s, size_t &off) {
+    static_assert(B > 0 && (B & (B - 1)) == 0, "must be a power of two");
+    s = 63 - __builtin_clzll(i / B + 1);
+    off = i - B * ((size_t(1) << s) - 1);
+}
+template <size_t B> constexpr unsigned count() {
+    return 64 - __builtin_ctzll(B);
+}
+// the ready flags of the `s` segment
+template <size_t B, typename T>
+std::atomic<uint8_t> *ready(T *raw, const unsigned s) {
+    return (std::atomic<uint8_t> *)(raw + (B << s));
+}
+// copies `src` in the uninitialized `dst`
+template <typename T> bool put(T &dst, const T &src) requires Copy<T> {
+    init(dst);
+    if (copy(dst, const_cast<T &>(src)) == false) {
+        if constexpr (Del<T>) {
+            del(dst);
+        }
+        return false;
+    }
+    return true;
+}
+template <typename T> bool put(T &dst, const T &src) requires NoCopy<T> {
+    dst = src;
+    return true;
+}
+// copies the `m` elements at `src` in the slots at `dst`, publishing them
+template <typename T>
+bool put(T *dst, std::atomic<uint8_t> *ready, const T *src,
+         const size_t m) requires Copy<T> {
+    for (size_t j = 0; j < m; ++j) {
+        if (put(dst[j], src[j]) == false) {
+            return false;
+        }
+        ready[j].store(1, std::memory_order_release);
+    }
+    return true;
+}
+template <typename T>
+bool put(T *dst, std::atomic<uint8_t> *ready, const T *src,
+         const size_t m) requires NoCopy<T> {
+    mem::cpy(dst, (T *)src, m);
+    for (size_t j = 0; j < m; ++j) {
+        ready[j].store(1, std::memory_order_release);
+    }
+    return true;
+}
+}
+
+template <typename T, size_t B = 64, typename A = mem::Libc> struct SegVec {
+    using Owned = T;
+    using Alloc = A;
+    std::atomic<size_t> size{0};
+    std::atomic<T *> segs[seg::count<B>()] = {};
+    // the element must be published, `at` checks it
+    T &operator[](const size_t i) {
+        unsigned s;
+        size_t off;
+        T *raw;
+        assert(i < size.load(std::memory_order_relaxed));
+        seg::locate<B>(i, s, off);
+        raw = segs[s].load(std::memory_order_acquire);
+        assert(raw && seg::ready<B>(raw, s)[off].load(
+                          std::memory_order_acquire));
+        return raw[off];
+    }
+};
+template <size_t B> void init(SegVec<auto, B, auto> &vec) {
+    vec.size.store(0, std::memory_order_relaxed);
+    for (auto &s : vec.segs) {
+        s.store(nullptr, std::memory_order_relaxed);
+    }
+}
+// the `s` segment, installed if needed, racing writers free theirs
+template <typename T, size_t B, typename A>
+T *segment(SegVec<T, B, A> &vec, const unsigned s) {
+    T *res = vec.segs[s].load(std::memory_order_acquire);
+    T *raw;
+    if (res != nullptr) {
+        return res;
+    }
+    if ((raw = (T *)A::alloc((B << s) * (sizeof(T) + 1))) == nullptr) {
+        return nullptr;
+    }
+    memset((void *)seg::ready<B>(raw, s), 0, B << s);
+    if (vec.segs[s].compare_exchange_strong(res, raw,
+                                            std::memory_order_acq_rel)) {
+        return raw;
+    }
+    mem::dalloc<A>(raw);
+    return res;
+}
+template <typename T, size_t B, typename A>
+T *at(SegVec<T, B, A> &vec, const size_t i) {
+    unsigned s;
+    size_t off;
+    seg::locate<B>(i, s, off);
+    T *res = vec.segs[s].load(std::memory_order_acquire);
+    if (res == nullptr ||
+        seg::ready<B>(res, s)[off].load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    return res + off;
+}
+// installs the segments of the first `n` slots
+template <typename T, size_t B, typename A>
+bool reserve(SegVec<T, B, A> &vec, const size_t n) {
+    unsigned s;
+    size_t off;
+    if (n == 0) {
+        return true;
+    }
+    seg::locate<B>(n - 1, s, off);
+    for (unsigned k = 0; k <= s; ++k) {
+        if (segment(vec, k) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+template <typename T, size_t B, typename A>
+bool push(SegVec<T, B, A> &vec, const T &ele) {
+    unsigned s;
+    size_t off;
+    T *raw;
+    seg::locate<B>(vec.size.fetch_add(1, std::memory_order_relaxed), s, off);
+    if ((raw = segment(vec, s)) == nullptr) {
+        return false;
+    }
+    if (seg::put(raw[off], ele) == false) {
+        return false;
+    }
+    seg::ready<B>(raw, s)[off].store(1, std::memory_order_release);
+    return true;
+}
+// claims `n` contiguous slots, copying `src` in them a segment at a time, on
+// failure the slots from the first that failed in a segment are unpublished
+template <typename T, size_t B, typename A>
+bool append(SegVec<T, B, A> &vec, const T *src, const size_t n) {
+    size_t i = vec.size.fetch_add(n, std::memory_order_relaxed);
+    size_t done = 0;
+    bool res = true;
+    while (done < n) {
+        unsigned s;
+        size_t off;
+        seg::locate<B>(i + done, s, off);
+        size_t m = (B << s) - off;
+        T *raw = segment(vec, s);
+        m = m < n - done ? m : n - done;
+        if (raw == nullptr) {
+            res = false;
+        } else if (seg::put(raw + off, seg::ready<B>(raw, s) + off, src + done,
+                            m) == false) {
+            res = false;
+        }
+        done += m;
+    }
+    return res;
+}
+// not concurrent with the writers, deletes the published elements
+template <typename T, size_t B, typename A>
+void del(SegVec<T, B, A> &vec) {
+    for (unsigned s = 0; s < seg::count<B>(); ++s) {
+        T *raw = vec.segs[s].load(std::memory_order_acquire);
+        if (raw == nullptr) {
+            continue;
+        }
+        if constexpr (Del<T>) {
+            std::atomic<uint8_t> *ready = seg::ready<B>(raw, s);
+            for (size_t i = 0; i < (B << s); ++i) {
+                if (ready[i].load(std::memory_order_relaxed)) {
+                    del(raw[i]);
+                }
+            }
+        }
+        mem::dalloc<A>(raw);
+    }
+    init(vec);
+}
+}
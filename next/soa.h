@@ -0,0 +1,155 @@
+#pragma once
+
+#include "com.h"
+#include "vec.h"
+
+#include <stdint.h>
+#include <tuple>
+#include <utility>
+
+namespace mtl {
+
+// Structure of arrays, a column per field, each allocated and grown by `A` as
+// a `Vec` would be, `reserved` being the smallest capacity of the columns.
+// `col<I>` returns a typed view of the `I`-th column, to stream over it.
+template <typename A, typename G, typename... Ts> struct Soa {
+    static_assert(sizeof...(Ts) > 0, "must have at least one column");
+    using Alloc = A;
+    using Grow = G;
+    size_t size = 0;
+    size_t reserved = 0;
+    std::tuple<Ts *...> cols{};
+};
+template <typename... Ts> using SoaVec = Soa<mem::Libc, grow::Double, Ts...>;
+
+template <typename T> struct Col {
+    using Owned = T;
+    T *data;
+    size_t size;
+    T &operator[](const size_t i) {
+        assert(i < size);
+        return data[i];
+    }
+};
+
+namespace mem {
+template <Del T> void edel(T *raw, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        del(raw[i]);
+    }
+}
+template <NoDel T> void edel(T *, const size_t) {}
+}
+
+namespace soa {
+// `f` on every column, in order, stopping at the first returning false
+template <typename... Ts, typename F> bool all(std::tuple<Ts *...> &cols, F f) {
+    return std::apply([&](auto *&... c) { return (f(c) && ...); }, cols);
+}
+// `f` on every column and its value
+template <typename... Ts, typename F>
+void zip(std::tuple<Ts *...> &cols, F f, const Ts &... vals) {
+    std::apply([&](auto *&... c) { (f(c, vals), ...); }, cols);
+}
+}
+
+template <size_t I, typename A, typename G, typename... Ts>
+auto col(Soa<A, G, Ts...> &vec) {
+    using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+    return Col<T>{std::get<I>(vec.cols), vec.size};
+}
+template <typename A, typename G, typename... Ts>
+void init(Soa<A, G, Ts...> &vec) {
+    vec.size = 0;
+    vec.reserved = 0;
+    vec.cols = {};
+}
+// on failure, the columns already grown keep their new storage
+template <typename A, typename G, typename... Ts>
+bool reserve(Soa<A, G, Ts...> &vec, const size_t ns) {
+    size_t cap = SIZE_MAX;
+    if (ns < vec.reserved) {
+        return true;
+    }
+    bool res = soa::all(vec.cols, [&](auto *&c) {
+        using T = std::remove_reference_t<decltype(*c)>;
+        size_t fit;
+        auto raw = mem::ralloc<A>(c, vec.size, ns);
+        if (raw == nullptr) {
+            return false;
+        }
+        c = raw;
+        fit = G::template fit<A>(raw, ns * sizeof(T)) / sizeof(T);
+        cap = fit < cap ? fit : cap;
+        return true;
+    });
+    if (res) {
+        vec.reserved = cap;
+    }
+    return res;
+}
+template <typename A, typename G, typename... Ts>
+bool push(Soa<A, G, Ts...> &vec, const Ts &... vals) {
+    if (vec.size == vec.reserved &&
+        reserve(vec, G::next(vec.reserved, 1)) == false) {
+        return false;
+    }
+    soa::zip(vec.cols, [&](auto *c, const auto &val) { c[vec.size] = val; },
+             vals...);
+    ++vec.size;
+    return true;
+}
+template <typename A, typename G, typename... Ts>
+void cutoff(Soa<A, G, Ts...> &vec, const size_t size) {
+    if (vec.size < size) {
+        return;
+    }
+    soa::all(vec.cols, [&](auto *c) {
+        mem::edel(c + size, vec.size - size);
+        return true;
+    });
+    vec.size = size;
+}
+template <typename A, typename G, typename... Ts>
+bool resize(Soa<A, G, Ts...> &vec, const size_t n, const Ts &... vals) {
+    if (vec.size >= n) {
+        cutoff(vec, n);
+        return true;
+    }
+    if (reserve(vec, n) == false) {
+        return false;
+    }
+    soa::zip(vec.cols,
+             [&](auto *c, const auto &val) {
+                 mem::efill(c + vec.size, val, n - vec.size);
+             },
+             vals...);
+    vec.size = n;
+    return true;
+}
+template <typename A, typename G, typename... Ts>
+bool resize(Soa<A, G, Ts...> &vec, const size_t n) requires(Init<Ts> &&...) {
+    if (vec.size >= n) {
+        cutoff(vec, n);
+        return true;
+    }
+    if (reserve(vec, n) == false) {
+        return false;
+    }
+    soa::all(vec.cols, [&](auto *c) {
+        mem::einit(c + vec.size, n - vec.size);
+        return true;
+    });
+    vec.size = n;
+    return true;
+}
+template <typename A, typename G, typename... Ts>
+void del(Soa<A, G, Ts...> &vec) {
+    soa::all(vec.cols, [&](auto *c) {
+        mem::edel(c, vec.size);
+        mem::dalloc<A>(c);
+        return true;
+    });
+    init(vec);
+}
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "com.h"
+#include "vec.h"
+#include "par.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+namespace mtl {
+
+// Sorting and searching over the data of the containers, in place, the
+// elements being moved as `cpy` does, bytewise, so the ones to relocate are
+// left out. `rsort` is a stable LSD radix sort on integral or floating keys,
+// `psort` a sample sort on the pool, for the larger inputs.
+
+template <typename T>
+concept bool Radix = std::is_integral<T>::value ||
+                     std::is_floating_point<T>::value;
+
+template <Cont C, typename L = std::less<>>
+void sort(C &c, L less = L()) requires NoReloc<typename C::Owned> {
+    std::sort(c.data, c.data + c.size, less);
+}
+template <Cont C, typename L = std::less<>>
+void stable_sort(C &c, L less = L()) requires NoReloc<typename C::Owned> {
+    std::stable_sort(c.data, c.data + c.size, less);
+}
+// the index of the first element not before `key`
+template <Cont C, typename K, typename L = std::less<>>
+size_t lower_bound(C &c, const K &key, L less = L()) {
+    return std::lower_bound(c.data, c.data + c.size, key, less) - c.data;
+}
+// the index of the first element after `key`
+template <Cont C, typename K, typename L = std::less<>>
+size_t upper_bound(C &c, const K &key, L less = L()) {
+    return std::upper_bound(c.data, c.data + c.size, key, less) - c.data;
+}
+
+namespace radix {
+// maps the key to unsigned bits in the same order, flipping the sign bit of
+// the integers, and all the bits of the negative floats
+template <Radix K> auto bits(const K k) {
+    if constexpr (std::is_floating_point<K>()) {
+        using U = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+        constexpr U sign = U(1) << (8 * sizeof(U) - 1);
+        U u;
+        memcpy(&u, &k, sizeof(K));
+        return U(u & sign ? ~u : u | sign);
+    } else if constexpr (std::is_signed<K>()) {
+        using U = std::make_unsigned_t<K>;
+        return U(U(k) ^ (U(1) << (8 * sizeof(U) - 1)));
+    } else {
+        return k;
+    }
+}
+}
+
+// sorts on `key(ele)`, a byte per pass, skipping the passes where all the
+// elements have the same byte; returns false if the scratch buffer can't be
+// allocated, leaving `c` as it was
+template <Cont C, typename F>
+bool rsort(C &c, F key) requires NoReloc<typename C::Owned> {
+    using T = typename C::Owned;
+    using U = decltype(radix::bits(key(*c.data)));
+    constexpr unsigned np = sizeof(U);
+    size_t hist[np][256] = {};
+    size_t n = c.size;
+    T *src = c.data;
+    T *dst;
+    if (n < 2) {
+        return true;
+    }
+    if ((dst = mem::ualloc<T>(n)) == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        U b = radix::bits(key(src[i]));
+        for (unsigned p = 0; p < np; ++p) {
+            ++hist[p][(b >> 8 * p) & 0xff];
+        }
+    }
+    for (unsigned p = 0; p < np; ++p) {
+        size_t *h = hist[p];
+        size_t sum = 0;
+        if (h[(radix::bits(key(src[0])) >> 8 * p) & 0xff] == n) {
+            continue;
+        }
+        for (unsigned d = 0; d < 256; ++d) {
+            size_t cnt = h[d];
+            h[d] = sum;
+            sum += cnt;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            unsigned d = (radix::bits(key(src[i])) >> 8 * p) & 0xff;
+            memcpy((void *)(dst + h[d]++), (void *)(src + i), sizeof(T));
+        }
+        std::swap(src, dst);
+    }
+    if (src != c.data) {
+        memcpy((void *)c.data, (void *)src, n * sizeof(T));
+        std::swap(src, dst);
+    }
+    mem::dalloc(dst);
+    return true;
+}
+template <Cont C> bool rsort(C &c) requires Radix<typename C::Owned> {
+    return rsort(c, [](const typename C::Owned &e) { return e; });
+}
+
+// splits the data in 4 buckets per thread, bounded by sampled splitters, each
+// thread counting then scattering its chunk to a scratch buffer, and sorts
+// the buckets in parallel; the equal elements all going to a bucket, heavy
+// duplicates limit the parallelism. Short inputs, or failed allocations, are
+// sorted on the calling thread.
+template <Cont C, typename L = std::less<>>
+void psort(C &c, L less = L(), par::Pool &p = par::pool()) requires
+    NoReloc<typename C::Owned> {
+    using T = typename C::Owned;
+    constexpr size_t over = 16;
+    size_t n = c.size;
+    size_t nc = p.nworkers + 1;
+    size_t nb = 4 * nc;
+    size_t ns = nb * over;
+    size_t *cnt = nullptr;
+    size_t *smp;
+    size_t *beg;
+    T *spl = nullptr;
+    T *tmp = nullptr;
+    if (p.nworkers == 0 || n * sizeof(T) < p.serial || n < ns ||
+        (tmp = mem::ualloc<T>(n)) == nullptr ||
+        (spl = mem::ualloc<T>(nb)) == nullptr ||
+        (cnt = mem::zalloc<size_t>(nc * nb + ns + nb + 1)) == nullptr) {
+        mem::dalloc(spl);
+        mem::dalloc(tmp);
+        std::sort(c.data, c.data + n, less);
+        return;
+    }
+    smp = cnt + nc * nb;
+    beg = smp + ns;
+    for (size_t i = 0; i < ns; ++i) {
+        smp[i] = i * (n / ns);
+    }
+    std::sort(smp, smp + ns,
+              [&](size_t a, size_t b) { return less(c.data[a], c.data[b]); });
+    // copied out, as the data are moved
+    for (size_t j = 0; j + 1 < nb; ++j) {
+        memcpy((void *)(spl + j), (void *)(c.data + smp[(j + 1) * over]),
+               sizeof(T));
+    }
+    auto bucket = [&](const T &e) {
+        size_t lo = 0;
+        size_t hi = nb - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (less(e, spl[mid])) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    };
+    par::tasks(p, nc, [&](size_t k) {
+        for (size_t i = n * k / nc; i < n * (k + 1) / nc; ++i) {
+            ++cnt[k * nb + bucket(c.data[i])];
+        }
+    });
+    for (size_t b = 0, sum = 0; b < nb; ++b) {
+        beg[b] = sum;
+        for (size_t k = 0; k < nc; ++k) {
+            size_t m = cnt[k * nb + b];
+            cnt[k * nb + b] = sum;
+            sum += m;
+        }
+    }
+    beg[nb] = n;
+    par::tasks(p, nc, [&](size_t k) {
+        for (size_t i = n * k / nc; i < n * (k + 1) / nc; ++i) {
+            size_t &at = cnt[k * nb + bucket(c.data[i])];
+            memcpy((void *)(tmp + at++), (void *)(c.data + i), sizeof(T));
+        }
+    });
+    par::tasks(p, nb, [&](size_t b) {
+        std::sort(tmp + beg[b], tmp + beg[b + 1], less);
+        memcpy((void *)(c.data + beg[b]), (void *)(tmp + beg[b]),
+               (beg[b + 1] - beg[b]) * sizeof(T));
+    });
+    mem::dalloc(spl);
+    mem::dalloc(cnt);
+    mem::dalloc(tmp);
+}
+}
@@ -1,41 +1,57 @@
 #pragma once
 
 #include "com.h"
+#include "arena.h"
+#include "map.h"
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace mtl {
 
 namespace mem {
 namespace raw {
-template <typename T> T *ualloc(const size_t n) {
-    return (T *)malloc(n * sizeof(T));
+template <typename T, typename A> T *ualloc(const size_t n) {
+    return (T *)A::alloc(n * sizeof(T));
 }
-template <typename T> T *zalloc(const size_t n) {
-    return (T *)calloc(n, sizeof(T));
+template <typename T, typename A> T *zalloc(const size_t n) {
+    return (T *)A::zalloc(n * sizeof(T));
 }
-template <typename T> T *ralloc(T *raw, const size_t, const size_t n) {
-    return (T *)realloc(raw, n * sizeof(T));
+template <typename A, typename T>
+T *ralloc(T *raw, const size_t os, const size_t n) {
+    return (T *)A::ralloc(raw, os * sizeof(T), n * sizeof(T));
 }
 }
 
-template <typename T> T *ualloc(const size_t n) { return raw::ualloc<T>(n); }
-template <NoReloc T> T *zalloc(const size_t n) { return raw::zalloc<T>(n); }
-template <NoReloc T> T *ralloc(T *raw, const size_t _, const size_t n) {
-    return raw::ralloc(raw, _, n);
+template <typename T, typename A = Libc> T *ualloc(const size_t n) {
+    return raw::ualloc<T, A>(n);
 }
-template <Reloc T> T *ralloc(T *raw, const size_t os, const size_t ns) {
+template <NoReloc T, typename A = Libc> T *zalloc(const size_t n) {
+    return raw::zalloc<T, A>(n);
+}
+template <typename A = Libc, NoReloc T>
+T *ralloc(T *raw, const size_t os, const size_t n) {
+    return raw::ralloc<A>(raw, os, n);
+}
+// the `os` elements are relocated only if the data moved
+template <typename A = Libc, Reloc T>
+T *ralloc(T *raw, const size_t os, const size_t ns) {
     T *res;
-    if ((res = raw::ralloc(raw, os, ns)) == nullptr) {
+    if ((res = raw::ralloc<A>(raw, os, ns)) == nullptr || res == raw) {
         return res;
     }
-    for (size_t i = os; i < ns; ++i) {
+    for (size_t i = 0; i < os && i < ns; ++i) {
         reloc(res[i]);
     }
     return res;
 }
+template <typename A = Libc> void dalloc(void *raw) { A::dalloc(raw); }
 template <NoReloc T> void cpy(T *dst, T *src, const size_t size) {
     memcpy(dst, src, size * sizeof(T));
 }
@@ -49,26 +65,147 @@ template <typename T> bool iszero(const T &ele) {
     char zero[sizeof(T)] = {0};
     return bcmp(&zero, &ele, sizeof(T)) == 0;
 }
-template <typename T> T *ealloc(const T &ele, const size_t size) {
+
+// broadcast fill kernels, `pat` holds the 32 bytes to repeat, `size` is a
+// multiple of the element size, so the tail is a prefix of `pat`
+namespace simd {
+inline void fill(char *dst, const char *pat, const size_t size) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        memcpy(dst + i, pat, 32);
+    }
+    memcpy(dst + i, pat, size - i);
+}
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2"))) inline void
+fill_sse(char *dst, const char *pat, const size_t size) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)pat);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)(pat + 16));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        _mm_storeu_si128((__m128i *)(dst + i), lo);
+        _mm_storeu_si128((__m128i *)(dst + i + 16), hi);
+    }
+    memcpy(dst + i, pat, size - i);
+}
+__attribute__((target("avx2"))) inline void
+fill_avx(char *dst, const char *pat, const size_t size) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)pat);
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+        _mm256_storeu_si256((__m256i *)(dst + i + 32), v);
+        _mm256_storeu_si256((__m256i *)(dst + i + 64), v);
+        _mm256_storeu_si256((__m256i *)(dst + i + 96), v);
+    }
+    for (; i + 32 <= size; i += 32) {
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+    }
+    memcpy(dst + i, pat, size - i);
+}
+#endif
+using Fill = void (*)(char *, const char *, const size_t);
+inline Fill pick() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return fill_avx;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return fill_sse;
+    }
+#endif
+    return fill;
+}
+// picked on first use, as static initializers of other units might fill
+inline Fill kernel() {
+    static const Fill res = pick();
+    return res;
+}
+}
+
+// fills `size` elements with `ele`, single bytes patterns go to memset, the
+// trivially copyable elements dividing 32 bytes to the widest kernel
+template <typename T> void efill(T *raw, const T &ele, const size_t size) {
+    if constexpr (std::is_trivially_copyable<T>() && 32 % sizeof(T) == 0) {
+        const char *bytes = reinterpret_cast<const char *>(&ele);
+        alignas(32) char pat[32];
+        if (bcmp(bytes, bytes + 1, sizeof(T) - 1) == 0) {
+            memset(raw, bytes[0], size * sizeof(T));
+            return;
+        }
+        for (size_t i = 0; i < 32; i += sizeof(T)) {
+            memcpy(pat + i, bytes, sizeof(T));
+        }
+        simd::kernel()(reinterpret_cast<char *>(raw), pat, size * sizeof(T));
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            raw[i] = ele;
+        }
+    }
+}
+// initializes `size` elements, with the type's bulk `init` when it has one
+template <BulkInit T> void einit(T *raw, const size_t size) {
+    init(raw, size);
+}
+template <NoBulkInit T> void einit(T *raw, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        init(raw[i]);
+    }
+}
+template <typename T, typename A = Libc>
+T *ealloc(const T &ele, const size_t size) {
     if (mem::iszero(ele)) {
-        return mem::zalloc<T>(size);
+        return mem::zalloc<T, A>(size);
     }
     T *res;
-    if ((res = mem::ualloc<T>(size)) == nullptr) {
+    if ((res = mem::ualloc<T, A>(size)) == nullptr) {
         return res;
     }
-    for (size_t i = 0; i < size; ++i) {
-        res[i] = ele;
-    }
+    mem::efill(res, ele, size);
     return res;
 }
 template <typename T> void ezero(T *raw, const size_t size) {
-    memset(raw, 0, sizeof(T) * size);
+    memset((void *)raw, 0, sizeof(T) * size);
 }
 }
 
-template <typename T> struct Vec {
+// Growth policies of `push`, `next` returns the new capacity of a full
+// container, and `fit` the bytes usable from an `n` bytes allocation: `Fit`
+// asks the allocator, so that its size classes are used up, the others keep
+// what they asked for.
+namespace grow {
+struct Double {
+    static size_t next(const size_t reserved, const size_t initn) {
+        return reserved ? 2 * reserved : initn;
+    }
+    template <typename A> static size_t fit(void *, const size_t n) {
+        return n;
+    }
+};
+struct Half {
+    static size_t next(const size_t reserved, const size_t initn) {
+        return reserved > 1 ? reserved + reserved / 2 : reserved + initn;
+    }
+    template <typename A> static size_t fit(void *, const size_t n) {
+        return n;
+    }
+};
+struct Fit {
+    static size_t next(const size_t reserved, const size_t initn) {
+        return reserved ? 2 * reserved : initn;
+    }
+    template <typename A> static size_t fit(void *raw, const size_t n) {
+        return A::usable(raw, n);
+    }
+};
+}
+
+template <typename T, typename A = mem::Libc, typename G = grow::Double>
+struct Vec {
     using Owned = T;
+    using Alloc = A;
+    using Grow = G;
     size_t size = 0;
     size_t reserved = 0;
     T *data = nullptr;
@@ -77,40 +214,41 @@ template <typename T> struct Vec {
         return data[i];
     }
 };
-bool make(Vec<NoReloc> &vec, const size_t size, const NoReloc &ele) {
+template <NoReloc T, typename A, typename G>
+bool make(Vec<T, A, G> &vec, const size_t size, const T &ele) {
     if (vec.size) {
         return false;
     }
-    if ((vec.data = mem::ealloc(ele, size)) == nullptr) {
+    if ((vec.data = mem::ealloc<T, A>(ele, size)) == nullptr) {
         return false;
     }
     vec.size = size;
     vec.reserved = size;
     return true;
 }
-bool reserve(Vec<auto> &vec, const size_t ns) {
+template <typename T, typename A, typename G>
+bool reserve(Vec<T, A, G> &vec, const size_t ns) {
     if (ns < vec.reserved) {
         return true;
     }
-    auto res = mem::ralloc(vec.data, vec.size, ns);
+    auto res = mem::ralloc<A>(vec.data, vec.size, ns);
     if (res == nullptr) {
         return false;
     }
     vec.data = res;
-    vec.reserved = ns;
+    vec.reserved = G::template fit<A>(res, ns * sizeof(T)) / sizeof(T);
     return true;
 }
-template <Init T> bool make(Vec<T> &vec, const size_t size) {
+template <Init T, typename A, typename G>
+bool make(Vec<T, A, G> &vec, const size_t size) {
     if (vec.size) {
         return false;
     }
-    if ((vec.data = mem::ualloc<T>(size)) == nullptr) {
+    if ((vec.data = mem::ualloc<T, A>(size)) == nullptr) {
         return false;
     }
     vec.reserved = size;
-    for (size_t i = 0; i < (vec.size = size); ++i) {
-        init(vec[i]);
-    }
+    mem::einit(vec.data, vec.size = size);
     return true;
 }
 template <DnCont T, DnCont U> bool merge(T &dst, U &src) {
@@ -123,6 +261,7 @@ template <DnCont T, DnCont U> bool merge(T &dst, U &src) {
     dst.size = ns;
     return true;
 }
+// grows by the container's policy, `pusham` by half
 DnCont { T }
 bool push(T &dst, const auto &ele, const size_t initn = 1) {
     size_t ns;
@@ -130,7 +269,7 @@ bool push(T &dst, const auto &ele, const size_t initn = 1) {
         dst[dst.size++] = ele;
         return true;
     }
-    ns = dst.reserved ? 2 * dst.reserved : initn;
+    ns = T::Grow::next(dst.reserved, initn);
     if (reserve(dst, ns) == false) {
         return false;
     }
@@ -144,7 +283,7 @@ bool pusham(T &dst, const auto &ele, const size_t initn = 1) {
         dst[dst.size++] = ele;
         return true;
     }
-    ns = dst.reserved ? dst.reserved + dst.reserved / 2 : initn;
+    ns = grow::Half::next(dst.reserved, initn);
     if (reserve(dst, ns) == false) {
         return false;
     }
@@ -152,28 +291,100 @@ bool pusham(T &dst, const auto &ele, const size_t initn = 1) {
     return true;
 }
 
+// makes room for `n` more elements in a single reserve, growing at least by
+// the container's policy
+DnCont { T }
+bool room(T &dst, const size_t n) {
+    size_t ns = dst.size + n;
+    size_t gs;
+    if (ns <= dst.reserved) {
+        return true;
+    }
+    gs = T::Grow::next(dst.reserved, n);
+    return reserve(dst, gs > ns ? gs : ns);
+}
+// appends copies of the `n` elements at `src`, on failure `dst` keeps the ones
+// before the first that failed
+DnCont { T }
+bool append(T &dst, const typename T::Owned *src, const size_t n) requires
+    Copy<typename T::Owned> {
+    using E = typename T::Owned;
+    if (room(dst, n) == false) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i, ++dst.size) {
+        init(dst.data[dst.size]);
+        if (copy(dst.data[dst.size], const_cast<E &>(src[i])) == false) {
+            if constexpr (Del<E>) {
+                del(dst.data[dst.size]);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+DnCont { T }
+bool append(T &dst, const typename T::Owned *src, const size_t n) requires
+    NoCopy<typename T::Owned> {
+    if (room(dst, n) == false) {
+        return false;
+    }
+    mem::cpy(dst.data + dst.size, (typename T::Owned *)src, n);
+    dst.size += n;
+    return true;
+}
+template <DnCont T, Owner U> bool append(T &dst, U &src) {
+    return append(dst, src.data, src.size);
+}
+// adds `n` elements in place, initialized, returns the first or nullptr
+DnCont { T }
+auto emplace(T &dst, const size_t n = 1) requires Init<typename T::Owned> {
+    typename T::Owned *res = nullptr;
+    if (room(dst, n)) {
+        res = dst.data + dst.size;
+        mem::einit(res, n);
+        dst.size += n;
+    }
+    return res;
+}
+// the elements without `init` are left to the caller to build in place
+DnCont { T }
+auto emplace(T &dst, const size_t n = 1) requires NoInit<typename T::Owned> {
+    typename T::Owned *res = nullptr;
+    if (room(dst, n)) {
+        res = dst.data + dst.size;
+        dst.size += n;
+    }
+    return res;
+}
 Cont { C }
 void del(C &vec) requires Del<typename C::Owned> {
     for (size_t i = 0; i < vec.size; ++i) {
         del(vec[i]);
     }
-    free(vec.data);
+    mem::dalloc<typename C::Alloc>(vec.data);
     init(vec);
 }
 Cont { C }
 void del(C &vec) requires NoDel<typename C::Owned> {
-    free(vec.data);
+    mem::dalloc<typename C::Alloc>(vec.data);
     init(vec);
 }
 
-void init(Vec<auto> &vec) {
+void init(Vec<auto, auto, auto> &vec) {
     vec.size = 0;
     vec.reserved = 0;
     vec.data = nullptr;
 }
+// bulk version, an initialized `Vec` is all zeros
+void init(Vec<auto, auto, auto> *vec, const size_t n) { mem::ezero(vec, n); }
 
-template <typename T, size_t N = 16> struct MuVec {
+template <typename T, size_t N = 16, typename A = mem::Libc,
+          typename G = grow::Double>
+struct MuVec {
     using Owned = T;
+    using Alloc = A;
+    using Grow = G;
     size_t size = 0;
     size_t reserved = N;
     T *data = mem;
@@ -183,44 +394,41 @@ template <typename T, size_t N = 16> struct MuVec {
         return data[i];
     }
 };
-template <size_t N> void init(MuVec<auto, N> &vec) {
+template <size_t N> void init(MuVec<auto, N, auto, auto> &vec) {
     vec.size = 0;
     vec.reserved = N;
     vec.data = vec.mem;
     mem::ezero(vec.mem, N);
 }
-template <size_t N>
-bool make(MuVec<NoReloc, N> &vec, const size_t size, const NoReloc &ele) {
+template <NoReloc T, size_t N, typename A, typename G>
+bool make(MuVec<T, N, A, G> &vec, const size_t size, const T &ele) {
     if (vec.size) {
         return false;
     }
     if (vec.reserved > size) {
-        for (size_t i = 0; i < (vec.size = size); ++i) {
-            vec[i] = ele;
-        }
+        mem::efill(vec.data, ele, vec.size = size);
         return true;
     }
-    if ((vec.data = mem::ealloc(ele, size)) == nullptr) {
+    if ((vec.data = mem::ealloc<T, A>(ele, size)) == nullptr) {
         return false;
     }
     vec.size = size;
     vec.reserved = size;
     return true;
 }
-template <Init T, size_t N> bool make(MuVec<T, N> &vec, const size_t size) {
+template <Init T, size_t N, typename A, typename G>
+bool make(MuVec<T, N, A, G> &vec, const size_t size) {
     if (vec.size) {
         return false;
     }
     if (reserve(vec, size) == false) {
         return false;
     }
-    for (size_t i = 0; i < (vec.size = size); ++i) {
-        init(vec[i]);
-    }
+    mem::einit(vec.data, vec.size = size);
     return true;
 }
-template <typename T, size_t N>
-requires Del<T> void cutoff(MuVec<T, N> &vec, const size_t size) {
+template <typename T, size_t N, typename A, typename G>
+requires Del<T> void cutoff(MuVec<T, N, A, G> &vec, const size_t size) {
     if (vec.size < size) {
         return;
     }
@@ -229,8 +437,8 @@ requires Del<T> void cutoff(MuVec<T, N> &vec, const size_t size) {
     }
     vec.size = size;
 }
-template <typename T, size_t N>
-requires NoDel<T> void cutoff(MuVec<T, N> &vec, const size_t size) {
+template <typename T, size_t N, typename A, typename G>
+requires NoDel<T> void cutoff(MuVec<T, N, A, G> &vec, const size_t size) {
     if (vec.size < size) {
         return;
     }
@@ -253,7 +461,8 @@ void cutoff(C &vec, const size_t size) requires NoDel<typename C::Owned> {
     }
     vec.size = size;
 }
-template <Del T, size_t N> void shrink(MuVec<T, N> &vec, const size_t size) {
+template <Del T, size_t N, typename A, typename G>
+void shrink(MuVec<T, N, A, G> &vec, const size_t size) {
     if (vec.size < size) {
         return;
     }
@@ -264,17 +473,18 @@ template <Del T, size_t N> void shrink(MuVec<T, N> &vec, const size_t size) {
     if (vec.reserved == N) {
         return;
     } else if (vec.reserved > N && size > N) {
-        mem::ralloc(vec.data, vec.reserved, vec.size);
+        mem::ralloc<A>(vec.data, vec.reserved, vec.size);
         vec.reserved = size;
         return;
     } else {
         mem::cpy(vec.data, vec.mem, size);
-        free(vec.data);
+        mem::dalloc<A>(vec.data);
         vec.data = vec.mem;
         vec.reserved = N;
     }
 }
-template <NoDel T, size_t N> void shrink(MuVec<T, N> &vec, const size_t size) {
+template <NoDel T, size_t N, typename A, typename G>
+void shrink(MuVec<T, N, A, G> &vec, const size_t size) {
     if (vec.size < size) {
         return;
     }
@@ -282,60 +492,163 @@ template <NoDel T, size_t N> void shrink(MuVec<T, N> &vec, const size_t size) {
     if (vec.reserved == N) {
         return;
     } else if (vec.reserved > N && size > N) {
-        mem::ralloc(vec.data, vec.reserved, vec.size);
+        mem::ralloc<A>(vec.data, vec.reserved, vec.size);
         vec.reserved = size;
         return;
     } else {
         mem::cpy(vec.data, vec.mem, size);
-        free(vec.data);
+        mem::dalloc<A>(vec.data);
         vec.data = vec.mem;
         vec.reserved = N;
     }
 }
-template <size_t N> void reloc(MuVec<auto, N> &vec) {
+template <size_t N> void reloc(MuVec<auto, N, auto, auto> &vec) {
     if (vec.reserved > N) {
         return;
     }
     vec.data = vec.mem;
 }
-template <size_t N> void del(MuVec<Del, N> &vec) {
+template <Del T, size_t N, typename A, typename G>
+void del(MuVec<T, N, A, G> &vec) {
     for (size_t i = 0; i < vec.size; ++i) {
         del(vec[i]);
     }
-    if (vec.size > N) {
-        free(vec.data);
+    if (vec.data != vec.mem) {
+        mem::dalloc<A>(vec.data);
     }
     init(vec);
 }
-template <size_t N> void del(MuVec<NoDel, N> &vec) {
-    if (vec.size > N) {
-        free(vec.data);
+template <NoDel T, size_t N, typename A, typename G>
+void del(MuVec<T, N, A, G> &vec) {
+    if (vec.data != vec.mem) {
+        mem::dalloc<A>(vec.data);
     }
     init(vec);
 }
-template <typename T, size_t N>
-bool reserve(MuVec<T, N> &vec, const size_t ns) {
+template <typename T, size_t N, typename A, typename G>
+bool reserve(MuVec<T, N, A, G> &vec, const size_t ns) {
     T *res;
     if (ns < vec.reserved) {
         return true;
     }
-    if (vec.size < N) {
-        if ((res = mem::ualloc<T>(ns)) != nullptr) {
+    if (vec.data == vec.mem) {
+        if ((res = mem::ualloc<T, A>(ns)) != nullptr) {
+            mem::cpy(res, vec.data, vec.size);
+        }
+    } else {
+        res = mem::ralloc<A>(vec.data, vec.size, ns);
+    }
+    if (res == nullptr) {
+        return false;
+    }
+    vec.data = res;
+    vec.reserved = G::template fit<A>(res, ns * sizeof(T)) / sizeof(T);
+    return true;
+}
+
+// Compact `MuVec`, with 32 bits size and capacity, and an inline buffer left
+// uninitialized, sized so that the vector fills `L` cache lines, by default
+// the fewest holding an element.
+namespace mem {
+template <typename T> constexpr unsigned lines() {
+    return (2 * sizeof(uint32_t) + sizeof(T *) + sizeof(T) + 63) / 64;
+}
+}
+template <typename T, unsigned L = mem::lines<T>(), typename A = mem::Libc,
+          typename G = grow::Double>
+struct SmVec {
+    static_assert(alignof(T) <= 2 * sizeof(uint32_t) + sizeof(T *),
+                  "overaligned element");
+    using Owned = T;
+    using Alloc = A;
+    using Grow = G;
+    static constexpr uint32_t N =
+        (64 * L - 2 * sizeof(uint32_t) - sizeof(T *)) / sizeof(T);
+    uint32_t size = 0;
+    uint32_t reserved = N;
+    T *data = (T *)mem;
+    alignas(T) char mem[64 * L - 2 * sizeof(uint32_t) - sizeof(T *)];
+    T &operator[](const size_t i) {
+        assert(i < size);
+        return data[i];
+    }
+};
+template <unsigned L> void init(SmVec<auto, L, auto, auto> &vec) {
+    vec.size = 0;
+    vec.reserved = vec.N;
+    vec.data = (decltype(vec.data))vec.mem;
+}
+// the heap capacity is always above `N`
+template <typename T, unsigned L, typename A, typename G>
+bool reserve(SmVec<T, L, A, G> &vec, const size_t ns) {
+    T *res;
+    size_t fit;
+    if (ns <= vec.reserved) {
+        return true;
+    }
+    if (ns > UINT32_MAX) {
+        return false;
+    }
+    if (vec.data == (T *)vec.mem) {
+        if ((res = mem::ualloc<T, A>(ns)) != nullptr) {
             mem::cpy(res, vec.data, vec.size);
         }
     } else {
-        res = mem::ralloc(vec.data, vec.size, ns);
+        res = mem::ralloc<A>(vec.data, vec.size, ns);
     }
     if (res == nullptr) {
         return false;
     }
     vec.data = res;
-    vec.reserved = ns;
+    fit = G::template fit<A>(res, ns * sizeof(T)) / sizeof(T);
+    vec.reserved = fit < UINT32_MAX ? fit : UINT32_MAX;
     return true;
 }
+template <NoReloc T, unsigned L, typename A, typename G>
+bool make(SmVec<T, L, A, G> &vec, const size_t size, const T &ele) {
+    if (vec.size || reserve(vec, size) == false) {
+        return false;
+    }
+    mem::efill(vec.data, ele, size);
+    vec.size = size;
+    return true;
+}
+template <Init T, unsigned L, typename A, typename G>
+bool make(SmVec<T, L, A, G> &vec, const size_t size) {
+    if (vec.size || reserve(vec, size) == false) {
+        return false;
+    }
+    mem::einit(vec.data, size);
+    vec.size = size;
+    return true;
+}
+template <unsigned L> void reloc(SmVec<auto, L, auto, auto> &vec) {
+    if (vec.reserved > vec.N) {
+        return;
+    }
+    vec.data = (decltype(vec.data))vec.mem;
+}
+template <Del T, unsigned L, typename A, typename G>
+void del(SmVec<T, L, A, G> &vec) {
+    for (size_t i = 0; i < vec.size; ++i) {
+        del(vec[i]);
+    }
+    if (vec.data != (T *)vec.mem) {
+        mem::dalloc<A>(vec.data);
+    }
+    init(vec);
+}
+template <NoDel T, unsigned L, typename A, typename G>
+void del(SmVec<T, L, A, G> &vec) {
+    if (vec.data != (T *)vec.mem) {
+        mem::dalloc<A>(vec.data);
+    }
+    init(vec);
+}
 
-template <typename T> struct FixVec {
+template <typename T, typename A = mem::Libc> struct FixVec {
     using Owned = T;
+    using Alloc = A;
     size_t size = 0;
     T *data = nullptr;
     T &operator[](const size_t i) {
@@ -343,40 +656,44 @@ template <typename T> struct FixVec {
         return data[i];
     }
 };
-bool make(FixVec<NoReloc> &vec, const size_t size, const NoReloc &ele) {
-    if ((vec.data = mem::ealloc(ele, size)) == nullptr) {
+template <NoReloc T, typename A>
+bool make(FixVec<T, A> &vec, const size_t size, const T &ele) {
+    if ((vec.data = mem::ealloc<T, A>(ele, size)) == nullptr) {
         return false;
     }
     vec.size = size;
     return true;
 }
-template <Init T> bool make(FixVec<T> &vec, const size_t size) {
+template <Init T, typename A>
+bool make(FixVec<T, A> &vec, const size_t size) {
     if (vec.size) {
         return false;
     }
-    if ((vec.data = mem::ualloc<T>(size)) == nullptr) {
+    if ((vec.data = mem::ualloc<T, A>(size)) == nullptr) {
         return false;
     }
-    for (size_t i = 0; i < (vec.size = size); ++i) {
-        init(vec[i]);
-    }
+    mem::einit(vec.data, vec.size = size);
     return true;
 }
-void init(FixVec<auto> &vec) {
+void init(FixVec<auto, auto> &vec) {
     vec.size = 0;
     vec.data = nullptr;
 }
+void init(FixVec<auto, auto> *vec, const size_t n) { mem::ezero(vec, n); }
 
 template <DnCont T, DnCont U>
 bool copy(T &dst, U &src) requires Copy<typename U::Owned> {
+    using E = typename U::Owned;
     cutoff(dst, 0);
     if (reserve(dst, src.size) == false) {
         return false;
     }
-    mem::cpy(dst.data, src.data, src.size);
-    for (size_t i = 0; i < (dst.size = src.size); ++i) {
-        if (copy(src[i], dst[i]) == false) {
-            dst.size = i;
+    for (size_t i = 0; i < src.size; ++i, ++dst.size) {
+        init(dst.data[i]);
+        if (copy(dst.data[i], src.data[i]) == false) {
+            if constexpr (Del<E>) {
+                del(dst.data[i]);
+            }
             return false;
         }
     }
@@ -403,10 +720,8 @@ bool resize(T &vec, const size_t n, const NoReloc &ele) {
         if (reserve(vec, n) == false) {
             return false;
         }
-        size_t i = vec.size;
-        for (; i < (vec.size = n); ++i) {
-            vec[i] = ele;
-        }
+        mem::efill(vec.data + vec.size, ele, n - vec.size);
+        vec.size = n;
     }
     return true;
 }
@@ -420,10 +735,8 @@ bool resize(T &vec, const size_t n) requires Init<typename T::Owned> {
         if (reserve(vec, n) == false) {
             return false;
         }
-        size_t i = vec.size;
-        for (; i < (vec.size = n); ++i) {
-            init(vec[i]);
-        }
+        mem::einit(vec.data + vec.size, n - vec.size);
+        vec.size = n;
     }
     return true;
 }
@@ -0,0 +1,131 @@
+#ifndef DRAIN_H
+#define DRAIN_H
+
+#include "list.h"
+#include "../next/vec.h"
+
+namespace mtl {
+
+// moves the data of the `ele` list in `vec`, returns the first element that
+// didn't fit, if any
+template <typename T, unsigned N, typename A, typename B, typename... V>
+Ele<T> *spill(Vec<T, V...> &vec, MtList<T, N, A, B> &q, Ele<T> *ele) noexcept {
+    Ele<T> *next;
+    while (ele != nullptr) {
+        if (unlikely(vec.size == vec.reserved)) {
+            size_t ns = Vec<T, V...>::Grow::next(vec.reserved, 1);
+            if (reserve(vec, ns) == false) {
+                return ele;
+            }
+        }
+        if (likely((next = ele->next.load(relaxed)) != nullptr)) {
+            prefetch(next);
+        }
+        vec[vec.size++] = std::move(ele->data);
+        drop(q, ele);
+        ele = next;
+    }
+    return nullptr;
+}
+// collects in order the elements whose data didn't fit in `vec`
+template <typename T, unsigned N, typename A, typename B, typename... V>
+void spill(Vec<T, V...> &vec, MtList<T, N, A, B> &q, Ele<T> *ele,
+           Ele<T> *&head, Ele<T> *&last) noexcept {
+    if (head == nullptr) {
+        if (likely(vec.size < vec.reserved) ||
+            reserve(vec, Vec<T, V...>::Grow::next(vec.reserved, 1))) {
+            vec[vec.size++] = std::move(ele->data);
+            drop(q, ele);
+            return;
+        }
+    }
+    ele->next.store(nullptr, relaxed);
+    if (head == nullptr) {
+        head = ele;
+    } else {
+        last->next.store(ele, relaxed);
+    }
+    last = ele;
+}
+
+// Bulk retrieval functions, move the data of the whole list, or of the
+// elements matching `filt`, at the end of `vec`, in list order, and give the
+// elements back to the list's allocation policy.
+// Notes: on allocation failure, the elements that didn't fit are chained back
+//        at the end of the list, and false is returned.
+//        the whole list variant detaches it first, as `tail` does.
+template <typename T, typename A, typename B, typename... V>
+bool drain(MtList<T, 1, A, B> &q, Vec<T, V...> &vec) noexcept {
+    Ele<T> *rest = spill(vec, q, tail(q));
+    if (unlikely(rest != nullptr)) {
+        chain(q, rest);
+        return false;
+    }
+    return true;
+}
+template <typename T, typename F, typename A, typename B, typename... V>
+bool drain(MtList<T, 1, A, B> &q, Vec<T, V...> &vec, F filt) noexcept {
+    Ele<T> *head = nullptr;
+    Ele<T> *last = nullptr;
+    trim(q, filt, [&](auto *ele) { spill(vec, q, ele, head, last); });
+    if (unlikely(head != nullptr)) {
+        chain(q, head, last);
+        return false;
+    }
+    return true;
+}
+
+// multiple insertion points variants, working on the `m` entry's segment only
+
+template <typename T, unsigned N, typename A, typename B, typename... V>
+bool drain(MtList<T, N, A, B> &q, unsigned m, Vec<T, V...> &vec) noexcept {
+    Ele<T> *rest = spill(vec, q, chunk(q, m));
+    if (unlikely(rest != nullptr)) {
+        chain(q, m, rest);
+        return false;
+    }
+    return true;
+}
+template <typename T, typename F, unsigned N, typename A, typename B,
+          typename... V>
+bool drain(MtList<T, N, A, B> &q, unsigned m, Vec<T, V...> &vec,
+           F filt) noexcept {
+    Ele<T> *head = nullptr;
+    Ele<T> *last = nullptr;
+    Ele<T> *end;
+    Ele<T> *prev;
+    Ele<T> *curr;
+    Ele<T> *next;
+    if (m > N - 1) {
+        m = 0;
+    }
+    end = bound(q, m);
+    prev = &q.entry[m];
+    curr = lock(q, m, prev);
+    while (curr != end) {
+        bool cond = filt(curr->data);
+        next = lock(q, m, curr);
+        if (unlikely(cond)) {
+            if (next == end) {
+                setback(q, m, curr, prev);
+            }
+            spill(vec, q, curr, head, last);
+        } else {
+            if (likely(next)) {
+                prefetch(next->data);
+            }
+            unlock(q, prev, curr, release);
+            prev = curr;
+        }
+        curr = next;
+    }
+    unlock(q, prev, end, release);
+    if (unlikely(head != nullptr)) {
+        chain(q, m, head, last);
+        return false;
+    }
+    return true;
+}
+}
+
+#endif // DRAIN_H
@@ -0,0 +1,178 @@
+namespace mtl {
+
+// epoch based reclamation, readers announce the global epoch while they walk
+// a list without locks, and the dropped elements are freed only once the
+// epoch moved twice past the one they were dropped in, as by then every
+// reader that could have reached them left.
+
+namespace epoch {
+
+static constexpr uint64_t idle = ~(uint64_t)0;
+static constexpr size_t batch = 64;
+
+struct Retired {
+    void *ptr;
+    void (*free)(void *);
+    uint64_t epoch;
+};
+// per thread record, `local` is the announced epoch, `idle` outside of the
+// read sections, the rest is only touched by the owning thread; records are
+// never freed, those of the exited threads are adopted by the new ones, with
+// what they had left to free
+struct alignas(cacheln) Rec {
+    std::atomic<uint64_t> local;
+    std::atomic<bool> used;
+    unsigned depth;
+    Retired *bag;
+    size_t size;
+    size_t cap;
+    Rec *next;
+};
+struct Domain {
+    alignas(cacheln) std::atomic<uint64_t> global{0};
+    alignas(cacheln) std::atomic<Rec *> recs{nullptr};
+};
+inline Domain &domain() noexcept {
+    static Domain d;
+    return d;
+}
+inline Rec *adopt() noexcept {
+    Domain &d = domain();
+    Rec *rec;
+    for (rec = d.recs.load(acquire); rec != nullptr; rec = rec->next) {
+        bool used = false;
+        if (!rec->used.load(relaxed) &&
+            rec->used.compare_exchange_strong(used, true, acquire)) {
+            return rec;
+        }
+    }
+    rec = new Rec;
+    rec->local.store(idle, relaxed);
+    rec->used.store(true, relaxed);
+    rec->depth = 0;
+    rec->bag = nullptr;
+    rec->size = 0;
+    rec->cap = 0;
+    rec->next = d.recs.load(relaxed);
+    while (!d.recs.compare_exchange_weak(rec->next, rec, release, relaxed)) {
+        continue;
+    }
+    return rec;
+}
+struct Local {
+    Rec *rec = nullptr;
+    ~Local() {
+        if (rec != nullptr) {
+            rec->used.store(false, release);
+        }
+    }
+};
+inline Rec &rec() noexcept {
+    static thread_local Local l;
+    if (unlikely(l.rec == nullptr)) {
+        l.rec = adopt();
+    }
+    return *l.rec;
+}
+
+// read sections, they nest
+inline void enter() noexcept {
+    Rec &r = rec();
+    if (r.depth++ == 0) {
+        r.local.store(domain().global.load(relaxed), relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+inline void leave() noexcept {
+    Rec &r = rec();
+    if (--r.depth == 0) {
+        r.local.store(idle, release);
+    }
+}
+struct Guard {
+    Guard() noexcept { enter(); }
+    ~Guard() noexcept { leave(); }
+};
+
+// moves the epoch forward if every reader announced the current one
+inline void advance() noexcept {
+    Domain &d = domain();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t e = d.global.load(relaxed);
+    for (Rec *r = d.recs.load(acquire); r != nullptr; r = r->next) {
+        uint64_t l = r->local.load(acquire);
+        if (l != idle && l != e) {
+            return;
+        }
+    }
+    d.global.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel,
+                                     relaxed);
+}
+// frees what the thread dropped two epochs ago or earlier
+inline void reclaim(Rec &r) noexcept {
+    uint64_t e = domain().global.load(acquire);
+    size_t kept = 0;
+    for (size_t i = 0; i < r.size; ++i) {
+        if (r.bag[i].epoch + 2 <= e) {
+            r.bag[i].free(r.bag[i].ptr);
+        } else {
+            r.bag[kept++] = r.bag[i];
+        }
+    }
+    r.size = kept;
+}
+// frees everything the thread dropped, waiting for the readers to leave
+// Notes: not from a read section, which would wait for itself.
+inline void flush() noexcept {
+    Domain &d = domain();
+    Rec &r = rec();
+    size_t spin = 0;
+    while (r.size > 0) {
+        advance();
+        reclaim(r);
+        if (r.size > 0) {
+            Backoff::wait(d.global, d.global.load(relaxed), spin++);
+        }
+    }
+}
+// frees `ptr` with `fn` once no reader can reach it; if the thread's bag can't
+// grow, it's freed after a `flush`, or leaked from a read section
+inline void retire(void *ptr, void (*fn)(void *)) noexcept {
+    Rec &r = rec();
+    if (unlikely(r.size == r.cap)) {
+        size_t cap = r.cap ? 2 * r.cap : batch;
+        Retired *bag;
+        bag = static_cast<Retired *>(realloc(r.bag, cap * sizeof(Retired)));
+        if (bag == nullptr) {
+            if (r.depth == 0) {
+                flush();
+                fn(ptr);
+            }
+            return;
+        }
+        r.bag = bag;
+        r.cap = cap;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    r.bag[r.size++] = {ptr, fn, domain().global.load(relaxed)};
+    if (r.size % batch == 0) {
+        advance();
+        reclaim(r);
+    }
+}
+}
+
+// `A` policy whose dropped elements are only freed once no reader can reach
+// them, to walk the lists without locks
+template <typename A> struct Epoch {
+    template <typename T, typename... V>
+    static Ele<T> *make(V &&... v) noexcept {
+        return A::template make<T>(std::forward<V>(v)...);
+    }
+    template <typename T> static void drop(Ele<T> *ele) noexcept {
+        epoch::retire(ele, [](void *raw) {
+            A::template drop<T>(static_cast<Ele<T> *>(raw));
+        });
+    }
+};
+}
@@ -5,6 +5,11 @@
 #include <atomic>
 #include <utility>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <mutex>
+#include <functional>
+#include <stdlib.h>
 
 namespace mtl {
 
@@ -18,97 +23,404 @@ template <typename T> struct Ele;
 // class of functions dedicated to removal will automatically delete it.
 template <typename T> struct Ele<T *>;
 
-// Lock-free list, with `N` insertion points, `N` is 1 by default.
+// Allocation policies for the elements, `Heap` uses new and delete, `Pool`
+// keeps freed elements in per thread caches, returning them to the cache of
+// the thread that allocated them.
+// Notes: `Pool` never gives memory back to the system.
+struct Heap;
+struct Pool;
+// Wraps the `A` policy, `Heap` by default, deferring the frees of the dropped
+// elements until no reader walking the list without locks can reach them.
+// Notes: the elements returned by `gather` and `tail` must be given back
+//        with `drop` too, as readers might still be on them.
+//        `epoch::flush` frees what the calling thread dropped, waiting for
+//        the readers.
+template <typename A = Heap> struct Epoch;
+
+// Wait policies, applied while an element lock is contended, `Busy` spins,
+// `Pause` spins with a cpu hint, `Backoff` waits exponentially longer and
+// `Park` sleeps on a futex after a short spin.
+// Notes: only `Park` makes unlocking more expensive, by a fence and a load.
+struct Busy;
+struct Pause;
+struct Backoff;
+struct Park;
+
+// Lock-free list, with `N` insertion points, `N` is 1 by default, elements are
+// allocated with the `A` policy, `Heap` by default, and contended locks are
+// waited with the `B` policy, `Busy` by default. The last element of each
+// insertion point's segment is kept in `back`.
 // Notes: no destructor is implemented.
 //        prefer `N = 1` specialization.
-template <typename T, unsigned N> struct MtList;
+template <typename T, unsigned N, typename A, typename B> struct MtList;
+
+// Spin statistics, the locks acquired, the failed attempts and the longest
+// wait of one entry, or of the whole list, and their reset. They are collected
+// in the bench.h `counters`, three per entry, only if MTL_SPINSTAT is defined,
+// otherwise they are always zero.
+// Notes: past the size of `counters` the lists share their slots.
+struct Spin;
+template <typename T, unsigned N, typename A, typename B>
+Spin snapshot(MtList<T, N, A, B> &, unsigned m) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+Spin snapshot(MtList<T, N, A, B> &) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void reset(MtList<T, N, A, B> &) noexcept;
+
+// Allocation functions, construct an element with the list's policy, either
+// from the provided data, or default constructed, and give it back.
+// Notes: returns nullptr on allocation failure.
+//        elements inserted in a list must be allocated with its policy.
+template <typename T, unsigned N, typename A, typename B, typename... V>
+Ele<T> *make(MtList<T, N, A, B> &, V &&...) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void drop(MtList<T, N, A, B> &, Ele<T> *) noexcept;
 
 // Tail insetion function, will insert the `e` provided list at the end of
-// the list.
-// Notes: `e` must be a nullptr terminated list.
-//        prefer other insertion methods.
-template <typename T, unsigned N>
-void chain(MtList<T, N> &, Ele<T> *e) noexcept;
+// the list, in constant time.
+// Notes: `e` must be a nullptr terminated list, that is walked to find its
+//        last element.
+template <typename T, unsigned N, typename A, typename B>
+void chain(MtList<T, N, A, B> &, Ele<T> *e) noexcept;
+// Inserts the list linked between `head` and `tail` at the end.
+// Notes: the list between `head` and `tail` must be valid.
+template <typename T, unsigned N, typename A, typename B>
+void chain(MtList<T, N, A, B> &, Ele<T> *head, Ele<T> *tail) noexcept;
 
 // Utility function, removes elements if owned data matches `filt`,
 // consequently applies `pred` to them. Returns immediatly if `cont` is set to
 // false.
 // Notes: `cont` is `true` by default
-template <typename T, typename P, typename F, unsigned N>
-void trim(MtList<T, N> &, F filt, P pred, bool cont) noexcept;
+template <typename T, typename P, typename F, unsigned N, typename A,
+          typename B>
+void trim(MtList<T, N, A, B> &, F filt, P pred, bool cont) noexcept;
 // same as `trim`, but `filt` will be applied to the current element's data,
 // and the pointer to the next element.
 // Notes: the next pointer applied to `filt` might be null.
-template <typename T, typename P, typename F, unsigned N>
-void trimzip(MtList<T, N> &, F, P, bool c) noexcept;
+template <typename T, typename P, typename F, unsigned N, typename A,
+          typename B>
+void trimzip(MtList<T, N, A, B> &, F, P, bool c) noexcept;
 
 // Insertion function, inserts, the list linked between `head` and `tail`,
 // after `pred` applied to an element matches.
 // Notes: the list between `head` and `tail` must be valid.
-template <typename T, typename P, unsigned N>
-bool insert(MtList<T, N> &, Ele<T> *head, Ele<T> *tail, P pred) noexcept;
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool insert(MtList<T, N, A, B> &, Ele<T> *head, Ele<T> *tail, P pred) noexcept;
 // Inserts just one element.
-template <typename T, typename P, unsigned N>
-bool insert(MtList<T, N> &, Ele<T> *, P) noexcept;
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool insert(MtList<T, N, A, B> &, Ele<T> *, P) noexcept;
 
 // Insertion function, inserts, the list linked between `head` and `tail`,
 // before `pred` applied to an element pointer matches.
 // Notes: the list between `head` and `tail` must be valid.
 //        the element pointer might be null.
-template <typename T, typename P, unsigned N>
-bool push(MtList<T, N> &q, Ele<T> *head, Ele<T> *tail, P pred) noexcept;
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool push(MtList<T, N, A, B> &q, Ele<T> *head, Ele<T> *tail, P pred) noexcept;
 // Inserts just one element.
-template <typename T, typename P, unsigned N>
-bool push(MtList<T, N> &q, Ele<T> *ele, P pred) noexcept;
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool push(MtList<T, N, A, B> &q, Ele<T> *ele, P pred) noexcept;
 // Inserts at the front.
-template <typename T, unsigned N>
-void push(MtList<T, N> &, Ele<T> *, Ele<T> *) noexcept;
-template <typename T, unsigned N> void push(MtList<T, N> &, Ele<T> *) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void push(MtList<T, N, A, B> &, Ele<T> *, Ele<T> *) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void push(MtList<T, N, A, B> &, Ele<T> *) noexcept;
 
 // Retrieval function, moves out of the list either the first data matching
 // `pred`, or returns the default constructed version.
 // Notes: std::move is called on the data.
-template <typename T, typename F, unsigned N>
-T get(MtList<T, N> &, F) noexcept;
+template <typename T, typename F, unsigned N, typename A, typename B>
+T get(MtList<T, N, A, B> &, F) noexcept;
 // Notes: if the `T *` if the data is not found nullptr, is returned
-template <typename T, typename F, unsigned N>
-T *get(MtList<T *, N> &, F pred) noexcept;
+template <typename T, typename F, unsigned N, typename A, typename B>
+T *get(MtList<T *, N, A, B> &, F pred) noexcept;
 
 // Removal function, removes the data matching `pred`.
 // Returnes the number of elements removed this way.
-template <typename T, typename F, unsigned N>
-size_t rm(MtList<T, N> &, F) noexcept;
+template <typename T, typename F, unsigned N, typename A, typename B>
+size_t rm(MtList<T, N, A, B> &, F) noexcept;
 // Deletes the data.
-template <typename T, typename F, unsigned N>
-size_t rm(MtList<T *, N> &, F) noexcept;
+template <typename T, typename F, unsigned N, typename A, typename B>
+size_t rm(MtList<T *, N, A, B> &, F) noexcept;
 
 // Retrieval function, moves out of the list either the last element's data, if
 // any, or returns the default constructed version.
 // Notes: prefer other retrieval functions.
-template <typename T, unsigned N> T last(MtList<T, N> &) noexcept;
+//        with multiple insertion points, `last`, `rmlast` and `chain` work on
+//        the end of the chosen entry's segment.
+template <typename T, unsigned N, typename A, typename B>
+T last(MtList<T, N, A, B> &) noexcept;
 // Notes: if the list is empty nullptr, is returned.
-template <typename T, unsigned N> T *last(MtList<T *, N> &) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+T *last(MtList<T *, N, A, B> &) noexcept;
 
 // Removal function, removes the last element of the list, if any, in case
 // returning true.
 // Notes: prefer other removal functions.
-template <typename T, unsigned N> bool rmlast(MtList<T, N> &) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+bool rmlast(MtList<T, N, A, B> &) noexcept;
 // Deletes the data.
-template <typename T, unsigned N> bool rmlast(MtList<T *, N> &) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+bool rmlast(MtList<T *, N, A, B> &) noexcept;
+
+// Read only functions, walk the list without locking the elements, waiting
+// on the locked ones, and apply `f` to every data, or to the first one
+// matching `filt`, returning whether there's one, or count the data matching
+// `filt`. They are only available with the `Epoch` policy, which keeps the
+// elements removed meanwhile alive until the walk ends.
+// Notes: the data are read while writers might move them out of removed
+//        elements, so they must be safe to read during a move, as trivially
+//        copyable data are; `T *` pointees taken with `get` aren't protected.
+//        a walk concurrent with removals might see removed elements, or see
+//        an element twice when `gather` runs.
+template <typename T, typename F, typename A, typename B>
+void for_each(MtList<T, 1, Epoch<A>, B> &, F f) noexcept;
+template <typename T, typename F, typename P, typename A, typename B>
+bool find(MtList<T, 1, Epoch<A>, B> &, F filt, P f) noexcept;
+template <typename T, typename F, typename A, typename B>
+size_t count(MtList<T, 1, Epoch<A>, B> &, F filt) noexcept;
 
 // Retrieval function, constructs a reversed list of the elements' data
 // matching `pred` and returns the pointer to the first element.
 // Notes: if no data matches, returns nullptr.
-template <typename T, typename F, unsigned N>
-Ele<T> *gather(MtList<T, N> &, F) noexcept;
+//        `drain`, in drain.h, moves the data in order into a `Vec` instead.
+template <typename T, typename F, unsigned N, typename A, typename B>
+Ele<T> *gather(MtList<T, N, A, B> &, F) noexcept;
 
 // Retrieval function, gets the entire list, if any.
 // Notes: if the list is empty returns nullptr.
-template <typename T, unsigned N> Ele<T> *tail(MtList<T, N> &) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *tail(MtList<T, N, A, B> &) noexcept;
+
+// Sharded front end of a list with `N` insertion points, every thread is
+// bound to one entry, producers append to it, consumers take its segment
+// first and steal the other entries' only when it's empty.
+template <typename T, unsigned N, typename A, typename B> struct Shard;
+
+// Insertion functions, append at the end of the thread's entry.
+template <typename T, unsigned N, typename A, typename B>
+void push(Shard<T, N, A, B> &, Ele<T> *head, Ele<T> *tail) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void push(Shard<T, N, A, B> &, Ele<T> *) noexcept;
+
+// Retrieval function, gets the thread's entry segment, or the first non empty
+// one of the others.
+// Notes: if every entry is empty returns nullptr.
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *chunk(Shard<T, N, A, B> &) noexcept;
+// Moves out the first element's data, looking in the same order, or returns
+// the default constructed version.
+template <typename T, unsigned N, typename A, typename B>
+T get(Shard<T, N, A, B> &) noexcept;
+
+// Priority front end of a list with `N` insertion points, up to 64, the `m`
+// entry's segment holds the level `m` data, 0 being the highest, and a bitmap
+// tracks the levels that might not be empty, so consumers go straight to the
+// highest non empty one instead of walking the empty entries.
+template <typename T, unsigned N, typename A, typename B> struct Prio;
+
+// Insertion functions, append the elements, linked by `next` for the second,
+// at the end of the `m` level, as a batch.
+// Notes: an out of range level is taken as 0.
+template <typename T, unsigned N, typename A, typename B>
+void push(Prio<T, N, A, B> &, unsigned m, Ele<T> *head, Ele<T> *tail) noexcept;
+template <typename T, unsigned N, typename A, typename B>
+void push(Prio<T, N, A, B> &, unsigned m, Ele<T> *) noexcept;
+
+// Retrieval function, gets the highest non empty level's segment.
+// Notes: if every level is empty returns nullptr.
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *chunk(Prio<T, N, A, B> &) noexcept;
+// Moves out the first data of the highest non empty level, or returns the
+// default constructed version.
+template <typename T, unsigned N, typename A, typename B>
+T get(Prio<T, N, A, B> &) noexcept;
+
+// Timer wheel, `L` levels of `S` slots, 4 of 64 by default, each an entry of
+// the underlying list, the level `l` slots spanning `S^l` ticks, so that
+// arming and cancelling are O(1) and the timers are taken a slot at a time.
+// Notes: ticks are the caller's unit, the wheel starts at the tick 0.
+//        `advance` isn't concurrent with itself, it walks every tick up to
+//        `now`, so it's O(1) per tick elapsed plus the timers it moves.
+template <typename T> struct Tick;
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+struct Wheel;
+
+// Makes a timer due at the `at` tick, with the data made from `v`, holding
+// two references, the wheel's, which goes with the timers `advance` returns,
+// and the handle's, given back with `cancel` or `drop`; `drop` gives back a
+// reference, the timer being freed with the last one.
+// Notes: a handle that won't cancel must still be dropped.
+template <typename T, unsigned L, unsigned S, typename A, typename B,
+          typename... V>
+Ele<Tick<T>> *make(Wheel<T, L, S, A, B> &, const uint64_t at,
+                   V &&... v) noexcept;
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void drop(Wheel<T, L, S, A, B> &, Ele<Tick<T>> *) noexcept;
+
+// Insertion function, arms the timer, one past due fires on the next
+// `advance`.
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void arm(Wheel<T, L, S, A, B> &, Ele<Tick<T>> *) noexcept;
+
+// Removal function, cancels the timer, returns false if it fired already,
+// and gives back the handle's reference.
+// Notes: the wheel drops its reference once the timer's slot is reached.
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+bool cancel(Wheel<T, L, S, A, B> &, Ele<Tick<T>> *) noexcept;
+
+// Retrieval function, moves the wheel to the `now` tick and gets the timers
+// due, linked by `next`, the cancelled ones being dropped.
+// Notes: if none is due returns nullptr.
+//        the timers must be given back with `drop`.
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+Ele<Tick<T>> *advance(Wheel<T, L, S, A, B> &, const uint64_t now) noexcept;
+
+// Hash table, the elements are chained in buckets hashed with `H`,
+// `std::hash<T>` by default, and compared to the keys with `E`,
+// `std::equal_to<>` by default, the buckets being split one at a time by the
+// inserts once there are twice as many elements, so that lookups lock a
+// handful of elements and no operation waits for the whole table to grow.
+// Notes: the elements are the `MtList` ones, those taken out of a list with
+//        the same `A` policy can be inserted without copying, and the other
+//        way round.
+//        `H` must hash the keys and the data alike.
+template <typename T, typename H, typename E, typename A, typename B>
+struct Table;
+
+template <typename T, typename H, typename E, typename A, typename B,
+          typename... V>
+Ele<T> *make(Table<T, H, E, A, B> &, V &&... v) noexcept;
+template <typename T, typename H, typename E, typename A, typename B>
+void drop(Table<T, H, E, A, B> &, Ele<T> *) noexcept;
+
+// Lookup function, applies `f` to the data equal to `key`, while it's
+// locked, returns false if there's none.
+// Notes: `f` must not change the hash of the data.
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K, typename F>
+bool find(Table<T, H, E, A, B> &, const K &key, F f) noexcept;
+
+// Insertion function, inserts the element unless its data is already in the
+// table, in which case returns false, the element staying the caller's.
+template <typename T, typename H, typename E, typename A, typename B>
+bool insert(Table<T, H, E, A, B> &, Ele<T> *) noexcept;
+
+// Removal functions, unlink the element whose data is equal to `key` and
+// return it, or nullptr, or drop it and return whether there was one.
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K>
+Ele<T> *take(Table<T, H, E, A, B> &, const K &key) noexcept;
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K>
+bool erase(Table<T, H, E, A, B> &, const K &key) noexcept;
+
+// Utility function, splits the buckets until there are `n`, returns false on
+// allocation failure.
+// Notes: waits for the running split, if any.
+template <typename T, typename H, typename E, typename A, typename B>
+bool rehash(Table<T, H, E, A, B> &, const size_t n) noexcept;
+
+// Ordered list, the elements are kept sorted by `C`, `std::less<>` by default,
+// and indexed by up to `H` levels of skip links, 12 by default, so that keyed
+// insertion, lookup and removal lock O(log n) elements instead of scanning.
+// Contended locks are waited with the `B` policy, `Busy` by default.
+// Notes: elements must be allocated with the list's `make`, each holds `H - 1`
+//        more links than the `MtList` ones.
+//        equal elements are kept in insertion order.
+template <typename T, typename C, unsigned H, typename B> struct Skip;
+
+template <typename T, typename C, unsigned H, typename B, typename... V>
+Ele<T> *make(Skip<T, C, H, B> &, V &&...) noexcept;
+template <typename T, typename C, unsigned H, typename B>
+void drop(Skip<T, C, H, B> &, Ele<T> *) noexcept;
+
+// Insertion function, inserts after the elements not greater than its data.
+template <typename T, typename C, unsigned H, typename B>
+void insert(Skip<T, C, H, B> &, Ele<T> *) noexcept;
+
+// Lookup function, applies `f` to the data of the first element equal to
+// `key`, while it's locked, returns false if there's none.
+// Notes: `f` must not change the order of the data.
+template <typename T, typename C, unsigned H, typename B, typename K,
+          typename F>
+bool find(Skip<T, C, H, B> &, const K &key, F f) noexcept;
+
+// Retrieval functions, move out of the list either the first data equal to
+// `key`, or the first data, or return the default constructed version.
+template <typename T, typename C, unsigned H, typename B, typename K>
+T get(Skip<T, C, H, B> &, const K &key) noexcept;
+template <typename T, typename C, unsigned H, typename B>
+T get(Skip<T, C, H, B> &) noexcept;
+
+// Removal function, removes the first data equal to `key`, in case returning
+// true.
+template <typename T, typename C, unsigned H, typename B, typename K>
+bool rm(Skip<T, C, H, B> &, const K &key) noexcept;
+
+// Retrieval functions, get the elements whose data matches `filt`, or the
+// entire list, in order, linked by `next`.
+// Notes: if no element is found returns nullptr.
+//        the elements must be given back with `drop`.
+template <typename T, typename C, unsigned H, typename B, typename F>
+Ele<T> *gather(Skip<T, C, H, B> &, F filt) noexcept;
+template <typename T, typename C, unsigned H, typename B>
+Ele<T> *tail(Skip<T, C, H, B> &) noexcept;
+
+// Unrolled list, the data are kept by value in blocks of `K`, by default as
+// many as fit in a cache line, so that small data take a fraction of an
+// element each, and traversals lock a block every `K` data. Contended locks
+// are waited with the `B` policy, `Busy` by default.
+// Notes: the data of a block are `data[K - count]` to `data[K - 1]`.
+//        owned data must be noexcept movable, and default constructable.
+//        the `T *` data are not owned.
+template <typename T, unsigned K, typename B> struct Unroll;
+template <typename T, unsigned K> struct Block;
+
+// Gives back the blocks returned by `gather` and `tail`, one at a time.
+template <typename T, unsigned K, typename B>
+void drop(Unroll<T, K, B> &, Block<T, K> *) noexcept;
+
+// Insertion function, inserts the data at the front, returns false on
+// allocation failure.
+template <typename T, unsigned K, typename B, typename V>
+bool push(Unroll<T, K, B> &, V &&) noexcept;
+
+// Utility function, as the `MtList` one, but `pred` is applied to the data
+// matching `filt`, which it must move out of.
+template <typename T, typename P, typename F, unsigned K, typename B>
+void trim(Unroll<T, K, B> &, F filt, P pred, bool cont = true) noexcept;
+
+// Retrieval and removal functions, as the `MtList` ones.
+template <typename T, typename F, unsigned K, typename B>
+T get(Unroll<T, K, B> &, F) noexcept;
+template <typename T, typename F, unsigned K, typename B>
+size_t rm(Unroll<T, K, B> &, F) noexcept;
+
+// Retrieval functions, get the data matching `filt`, moved in order in new
+// blocks, or the entire list.
+// Notes: if no data is found returns nullptr.
+//        on allocation failure `gather` leaves the rest of the data in the
+//        list.
+template <typename T, typename F, unsigned K, typename B>
+Block<T, K> *gather(Unroll<T, K, B> &, F filt) noexcept;
+template <typename T, unsigned K, typename B>
+Block<T, K> *tail(Unroll<T, K, B> &) noexcept;
 }
 
 #include "utils.h"
+#ifdef MTL_SPINSTAT
+#include "../bench.h"
+#endif
+#include "pool.h"
+#include "spin.h"
+#include "epoch.h"
 #include "slist.h"
 #include "mlist.h"
+#include "shard.h"
+#include "prio.h"
+#include "wheel.h"
+#include "table.h"
+#include "skip.h"
+#include "unroll.h"
 
 #endif // LIST_H
@@ -1,306 +1,129 @@
 namespace mtl {
 
-// methods to operate on multiple insertion points
+// methods to operate on multiple insertion points, the `M` entry's segment
+// ends where the next entry begins, its last element is tracked in `back[M]`
 
-template <unsigned N> struct Entry;
+template <unsigned N> struct Entry {};
 
-template <typename T, unsigned N, unsigned M>
-void chain(MtList<T, N> &q, Entry<M>, Ele<T> *ele) noexcept {
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+void chain(MtList<T, N, A, B> &q, Entry<M>, Ele<T> *ele) noexcept {
     static_assert(M < N, "must be inside the entry array");
-    Ele<T> *curr = &q.entry[M];
-    Ele<T> *prev = curr;
-    Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
-        prev->next.store(curr, relaxed);
-        prev = curr;
-        curr = next;
-    }
-    prev->next.store(ele, relaxed);
-    return;
+    chain(q, M, ele);
 }
-template <typename T, typename P, typename F, unsigned N, unsigned M>
-void trim(MtList<T, N> &q, Entry<M>, F filt, P pred,
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+void chain(MtList<T, N, A, B> &q, Entry<M>, Ele<T> *head,
+           Ele<T> *tail) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    chain(q, M, head, tail);
+}
+template <typename T, typename P, typename F, unsigned N, unsigned M,
+          typename A, typename B>
+void trim(MtList<T, N, A, B> &q, Entry<M>, F filt, P pred,
           bool cont = true) noexcept {
     static_assert(M < N, "must be inside the entry array");
-    Ele<T> *curr = &q.entry[M];
-    Ele<T> *prev = curr;
-    Ele<T> *next;
-    bool cond;
-    unsigned i = M;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    while (likely(curr)) {
-        next = curr;
-        if (unlikely(curr == q.entry + i + 1)) {
-            cond = false;
-            ++i;
-        } else {
-            cond = filt(curr->data);
-        }
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
-        if (unlikely(cond)) {
-            pred(curr);
-            if (!cont) {
-                prev->next.store(next, relaxed);
-                return;
-            }
-            curr = next;
-        } else {
-            if (likely(next)) {
-                prefetch(next->data);
-            }
-            prev->next.store(curr, relaxed);
-            prev = curr;
-            curr = next;
-        }
-    }
-    prev->next.store(nullptr, relaxed);
+    trim(q, M, filt, pred, cont);
 }
-template <typename T, typename P, typename F, unsigned N, unsigned M>
-void trimzip(MtList<T, N> &q, Entry<M>, F filt, P pred,
+template <typename T, typename P, typename F, unsigned N, unsigned M,
+          typename A, typename B>
+void trimzip(MtList<T, N, A, B> &q, Entry<M>, F filt, P pred,
              bool cont = true) noexcept {
     static_assert(M < N, "must be inside the entry array");
-    Ele<T> *curr = &q.entry[M];
-    Ele<T> *prev = curr;
-    Ele<T> *next;
-    bool cond;
-    unsigned i = M;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
-        if (unlikely(curr == q.entry + i + 1)) {
-            cond = false;
-            ++i;
-        } else {
-            cond = filt(curr->data);
-        }
-        if (unlikely(cond)) {
-            pred(curr);
-            if (!cont) {
-                prev->next.store(next, relaxed);
-                return;
-            }
-            curr = next;
-        } else {
-            if (likely(next)) {
-                prefetch(next->data);
-            }
-            prev->next.store(curr, relaxed);
-            prev = curr;
-            curr = next;
-        }
-    }
-    prev->next.store(nullptr, relaxed);
+    trimzip(q, M, filt, pred, cont);
 }
-
-template <typename T, unsigned N>
-Ele<T> *chunk(MtList<T, N> &q, unsigned m = 0) {
-    if (m > N - 1) {
-        m = 0;
-    }
-    Ele<T> *curr = &q.entry[m];
-    Ele<T> *prev = curr;
-    Ele<T> *head;
-    unsigned i = m;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    Ele<T> *nxentry = (i == N - 1) ? nullptr : &q.entry[i + 1];
-    q.entry[i].next.store(nxentry, relaxed);
-    head = curr;
-    prev = curr;
-    if (curr == nxentry) {
-        return nullptr;
-    }
-    do {
-        while ((curr = curr->next.exchange(curr, consume)) == prev) {
-            continue;
-        }
-        if (curr == nxentry) {
-            prev->next.store(nullptr, relaxed);
-            return head;
-        }
-        prev->next.store(curr, relaxed);
-        prev = curr;
-    } while (true);
-}
-
-template <typename T, typename P, unsigned N, unsigned M>
-bool insert(MtList<T, N> &q, Entry<M>, Ele<T> *head, Ele<T> *tail,
+template <typename T, typename P, unsigned N, unsigned M, typename A,
+          typename B>
+bool insert(MtList<T, N, A, B> &q, Entry<M>, Ele<T> *head, Ele<T> *tail,
             P pred) noexcept {
     static_assert(M < N, "must be inside the entry array");
-    Ele<T> *curr = &q.entry[M];
-    Ele<T> *prev = curr;
-    Ele<T> *next;
-    bool cond;
-    unsigned i = M;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    while (likely(curr)) {
-        next = curr;
-        if (unlikely(curr == q.entry + i + 1)) {
-            cond = false;
-            ++i;
-        } else {
-            cond = pred(prev, curr);
-        }
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
-        if (unlikely(cond)) {
-            tail->next.store(next, relaxed);
-            curr->next.store(head, release);
-            return true;
-        } else {
-            if (likely(next)) {
-                prefetch(next->data);
-            }
-            prev->next.store(curr, relaxed);
-            prev = curr;
-            curr = next;
-        }
-    }
-    prev->next.store(nullptr, relaxed);
-    return false;
+    return insert(q, M, head, tail, pred);
 }
-
-template <typename T, typename P, unsigned N, unsigned M>
-bool insert(MtList<T, N> &q, Entry<M> e, Ele<T> *ele, P pred) noexcept {
+template <typename T, typename P, unsigned N, unsigned M, typename A,
+          typename B>
+bool insert(MtList<T, N, A, B> &q, Entry<M> e, Ele<T> *ele, P pred) noexcept {
     return insert(q, e, ele, ele, pred);
 }
-
-template <typename T, unsigned N, unsigned M>
-void push(MtList<T, N> &q, Entry<M>, Ele<T> *head, Ele<T> *tail) noexcept {
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+void push(MtList<T, N, A, B> &q, Entry<M>, Ele<T> *head,
+          Ele<T> *tail) noexcept {
     static_assert(M < N, "must be inside the entry array");
-    Ele<T> *curr = &q.entry[M];
-    Ele<T> *prev = curr;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    tail->next.store(curr, relaxed);
-    prev->next.store(head, release);
+    push(q, M, head, tail);
 }
-template <typename T, unsigned N, unsigned M>
-void push(MtList<T, N> &q, Entry<M> e, Ele<T> *ele) noexcept {
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+void push(MtList<T, N, A, B> &q, Entry<M> e, Ele<T> *ele) noexcept {
     push(q, e, ele, ele);
 }
-template <typename T, typename F, unsigned N, unsigned M>
-T *get(MtList<T *, N> &q, Entry<M> e, F filt) noexcept {
-    T *res = nullptr;
-    trim(q, e, filt,
-         [&](auto *ele) {
-             std::swap(res, ele->data);
-             delete ele;
-         },
-         false);
-    return res;
+template <typename T, typename F, unsigned N, unsigned M, typename A,
+          typename B>
+T *get(MtList<T *, N, A, B> &q, Entry<M>, F filt) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return get(q, M, filt);
 }
-template <typename T, typename F, unsigned N, unsigned M>
-T get(MtList<T, N> &q, Entry<M> e, F filt) noexcept {
-    T res = {};
-    trim(q, e, filt,
-         [&](auto *ele) {
-             res = std::move(ele->data);
-             delete ele;
-         },
-         false);
-    return res;
+template <typename T, typename F, unsigned N, unsigned M, typename A,
+          typename B>
+T get(MtList<T, N, A, B> &q, Entry<M>, F filt) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return get(q, M, filt);
 }
-template <typename T, typename F, unsigned N, unsigned M>
-size_t rm(MtList<T, N> &q, Entry<M> e, F filt) noexcept {
-    size_t n = 0;
-    trim(q, e, filt, [&](auto *ele) {
-        delete ele;
-        ++n;
-    });
-    return n;
+template <typename T, typename F, unsigned N, unsigned M, typename A,
+          typename B>
+size_t rm(MtList<T, N, A, B> &q, Entry<M>, F filt) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return rm(q, M, filt);
 }
-template <typename T, unsigned N, unsigned M>
-T last(MtList<T, N> &q, Entry<M> e = Entry<N - 1>()) noexcept {
-    T res = {};
-    trimzip(q, e, [](T, Ele<T> *nx) { return nx == nullptr; },
-            [&](auto *ele) {
-                res = std::move(ele->data);
-                delete ele;
-            },
-            false);
-    return res;
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+T last(MtList<T, N, A, B> &q, Entry<M>) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return last(q, M);
 }
-template <typename T, unsigned N, unsigned M>
-T *last(MtList<T *, N> &q, Entry<M> e = Entry<N - 1>()) noexcept {
-    T *res = nullptr;
-    trimzip(q, e, [](T, Ele<T> *nx) { return nx == nullptr; },
-            [&](auto *ele) {
-                std::swap(res, ele->data);
-                delete ele;
-            },
-            false);
-    return res;
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+T *last(MtList<T *, N, A, B> &q, Entry<M>) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return last(q, M);
 }
-template <typename T, unsigned N, unsigned M>
-bool rmlast(MtList<T, N> &q, Entry<M> e = Entry<N - 1>()) noexcept {
-    Ele<T> *res = nullptr;
-    trimzip(q, e, [](auto, auto *nx) { return nx == nullptr; },
-            [&](auto *ele) { res = ele; }, false);
-    if (res) {
-        delete res;
-        return true;
-    }
-    return false;
+template <typename T, unsigned N, unsigned M, typename A, typename B>
+bool rmlast(MtList<T, N, A, B> &q, Entry<M>) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return rmlast(q, M);
 }
-template <typename T, typename F, unsigned N, unsigned M>
-Ele<T> *gather(MtList<T, N> &q, Entry<M> e, F filt) noexcept {
-    Ele<T> *head = nullptr;
-    trim(q, e, filt, [&](auto *ele) {
-        ele->next = head;
-        head = ele;
-    });
-    return head;
+template <typename T, typename F, unsigned N, unsigned M, typename A,
+          typename B>
+Ele<T> *gather(MtList<T, N, A, B> &q, Entry<M>, F filt) noexcept {
+    static_assert(M < N, "must be inside the entry array");
+    return gather(q, M, filt);
 }
 
 // methods without insertion range checking
 
-template <typename T, unsigned N>
-void chain(MtList<T, N> &q, unsigned m, Ele<T> *ele) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *bound(MtList<T, N, A, B> &q, unsigned m) noexcept {
+    return (m == N - 1) ? nullptr : &q.entry[m + 1];
+}
+template <typename T, unsigned N, typename A, typename B>
+void chain(MtList<T, N, A, B> &q, unsigned m, Ele<T> *head,
+           Ele<T> *tail) noexcept {
     if (m > N - 1) {
         m = 0;
     }
-    Ele<T> *curr = &q.entry[m];
-    Ele<T> *prev = curr;
+    Ele<T> *last = lockback(q, m);
+    tail->next.store(bound(q, m), relaxed);
+    unlock(q, last, head, release);
+    unback(q, m, tail, release);
+}
+template <typename T, unsigned N, typename A, typename B>
+void chain(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele) noexcept {
+    Ele<T> *tail = ele;
     Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
+    if (unlikely(ele == nullptr)) {
+        return;
     }
-    while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
-        prev->next.store(curr, relaxed);
-        prev = curr;
-        curr = next;
+    while ((next = tail->next.load(relaxed)) != nullptr) {
+        tail = next;
     }
-    prev->next.store(ele, relaxed);
-    return;
+    chain(q, m, ele, tail);
 }
-template <typename T, typename P, typename F, unsigned N>
-void trim(MtList<T, N> &q, unsigned m, F filt, P pred,
+template <typename T, typename P, typename F, unsigned N, typename A,
+          typename B>
+void trim(MtList<T, N, A, B> &q, unsigned m, F filt, P pred,
           bool cont = true) noexcept {
     if (m > N - 1) {
         m = 0;
@@ -310,24 +133,22 @@ void trim(MtList<T, N> &q, unsigned m, F filt, P pred,
     Ele<T> *next;
     bool cond;
     unsigned i = m;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, m, curr);
     while (likely(curr)) {
-        next = curr;
         if (unlikely(curr == q.entry + i + 1)) {
             cond = false;
             ++i;
         } else {
             cond = filt(curr->data);
         }
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, i, curr);
         if (unlikely(cond)) {
+            if (next == bound(q, i)) {
+                setback(q, i, curr, prev);
+            }
             pred(curr);
             if (!cont) {
-                prev->next.store(next, relaxed);
+                unlock(q, prev, next, relaxed);
                 return;
             }
             curr = next;
@@ -335,15 +156,16 @@ void trim(MtList<T, N> &q, unsigned m, F filt, P pred,
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, relaxed);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, relaxed);
 }
-template <typename T, typename P, typename F, unsigned N>
-void trimzip(MtList<T, N> &q, unsigned m, F filt, P pred,
+template <typename T, typename P, typename F, unsigned N, typename A,
+          typename B>
+void trimzip(MtList<T, N, A, B> &q, unsigned m, F filt, P pred,
              bool cont = true) noexcept {
     if (m > N - 1) {
         m = 0;
@@ -353,24 +175,22 @@ void trimzip(MtList<T, N> &q, unsigned m, F filt, P pred,
     Ele<T> *next;
     bool cond;
     unsigned i = m;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, m, curr);
     while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, i, curr);
         if (unlikely(curr == q.entry + i + 1)) {
             cond = false;
             ++i;
         } else {
-            cond = filt(curr->data);
+            cond = filt(curr->data, next);
         }
         if (unlikely(cond)) {
+            if (next == bound(q, i)) {
+                setback(q, i, curr, prev);
+            }
             pred(curr);
             if (!cont) {
-                prev->next.store(next, relaxed);
+                unlock(q, prev, next, relaxed);
                 return;
             }
             curr = next;
@@ -378,15 +198,45 @@ void trimzip(MtList<T, N> &q, unsigned m, F filt, P pred,
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, relaxed);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, relaxed);
 }
-template <typename T, typename P, unsigned N>
-bool insert(MtList<T, N> &q, unsigned m, Ele<T> *head, Ele<T> *tail,
+
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *chunk(MtList<T, N, A, B> &q, unsigned m = 0) {
+    if (m > N - 1) {
+        m = 0;
+    }
+    Ele<T> *curr = &q.entry[m];
+    Ele<T> *prev = curr;
+    Ele<T> *head;
+    curr = lock(q, m, curr);
+    Ele<T> *nxentry = bound(q, m);
+    if (curr == nxentry) {
+        unlock(q, &q.entry[m], nxentry, relaxed);
+        return nullptr;
+    }
+    setback(q, m, &q.entry[m]);
+    unlock(q, &q.entry[m], nxentry, relaxed);
+    head = curr;
+    prev = curr;
+    do {
+        curr = lock(q, m, curr);
+        if (curr == nxentry) {
+            unlock(q, prev, nullptr, relaxed);
+            return head;
+        }
+        unlock(q, prev, curr, relaxed);
+        prev = curr;
+    } while (true);
+}
+
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool insert(MtList<T, N, A, B> &q, unsigned m, Ele<T> *head, Ele<T> *tail,
             P pred) noexcept {
     if (m > N - 1) {
         m = 0;
@@ -396,125 +246,129 @@ bool insert(MtList<T, N> &q, unsigned m, Ele<T> *head, Ele<T> *tail,
     Ele<T> *next;
     bool cond;
     unsigned i = m;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, m, curr);
     while (likely(curr)) {
-        next = curr;
         if (unlikely(curr == q.entry + i + 1)) {
             cond = false;
             ++i;
         } else {
             cond = pred(prev, curr);
         }
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, i, curr);
         if (unlikely(cond)) {
             tail->next.store(next, relaxed);
-            curr->next.store(head, release);
+            if (next == bound(q, i)) {
+                setback(q, i, curr, tail);
+            }
+            unlock(q, curr, head, release);
+            unlock(q, prev, curr, relaxed);
             return true;
         } else {
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, relaxed);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, relaxed);
     return false;
 }
 
-template <typename T, typename P, unsigned N>
-bool insert(MtList<T, N> &q, unsigned m, Ele<T> *ele, P pred) noexcept {
+template <typename T, typename P, unsigned N, typename A, typename B>
+bool insert(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele, P pred) noexcept {
     return insert(q, m, ele, ele, pred);
 }
 
-template <typename T, unsigned N>
-void push(MtList<T, N> &q, unsigned m, Ele<T> *head, Ele<T> *tail) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+void push(MtList<T, N, A, B> &q, unsigned m, Ele<T> *head,
+          Ele<T> *tail) noexcept {
     if (m > N - 1) {
         m = 0;
     }
     Ele<T> *curr = &q.entry[m];
     Ele<T> *prev = curr;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, m, curr);
     tail->next.store(curr, relaxed);
-    prev->next.store(head, release);
+    if (curr == bound(q, m)) {
+        setback(q, m, prev, tail);
+    }
+    unlock(q, prev, head, release);
 }
-template <typename T, unsigned N>
-void push(MtList<T, N> &q, unsigned m, Ele<T> *ele) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+void push(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele) noexcept {
     push(q, m, ele, ele);
 }
-template <typename T, typename F, unsigned N>
-T *get(MtList<T *, N> &q, unsigned m, F filt) noexcept {
+template <typename T, typename F, unsigned N, typename A, typename B>
+T *get(MtList<T *, N, A, B> &q, unsigned m, F filt) noexcept {
     T *res = nullptr;
     trim(q, m, filt,
          [&](auto *ele) {
              std::swap(res, ele->data);
-             delete ele;
+             drop(q, ele);
          },
          false);
     return res;
 }
-template <typename T, typename F, unsigned N>
-T get(MtList<T, N> &q, unsigned m, F filt) noexcept {
+template <typename T, typename F, unsigned N, typename A, typename B>
+T get(MtList<T, N, A, B> &q, unsigned m, F filt) noexcept {
     T res = {};
     trim(q, m, filt,
          [&](auto *ele) {
              res = std::move(ele->data);
-             delete ele;
+             drop(q, ele);
          },
          false);
     return res;
 }
-template <typename T, typename F, unsigned N>
-size_t rm(MtList<T, N> &q, unsigned m, F filt) noexcept {
+template <typename T, typename F, unsigned N, typename A, typename B>
+size_t rm(MtList<T, N, A, B> &q, unsigned m, F filt) noexcept {
     size_t n = 0;
     trim(q, m, filt, [&](auto *ele) {
-        delete ele;
+        drop(q, ele);
         ++n;
     });
     return n;
 }
-template <typename T, unsigned N>
-T last(MtList<T, N> &q, unsigned m = N - 1) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+T last(MtList<T, N, A, B> &q, unsigned m = N - 1) noexcept {
     T res = {};
-    trimzip(q, m, [](T, Ele<T> *nx) { return nx == nullptr; },
+    Ele<T> *end = bound(q, m > N - 1 ? 0 : m);
+    trimzip(q, m, [&](const T &, Ele<T> *nx) { return nx == end; },
             [&](auto *ele) {
                 res = std::move(ele->data);
-                delete ele;
+                drop(q, ele);
             },
             false);
     return res;
 }
-template <typename T, unsigned N>
-T *last(MtList<T *, N> &q, unsigned m = N - 1) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+T *last(MtList<T *, N, A, B> &q, unsigned m = N - 1) noexcept {
     T *res = nullptr;
-    trimzip(q, m, [](T, Ele<T> *nx) { return nx == nullptr; },
+    Ele<T *> *end = bound(q, m > N - 1 ? 0 : m);
+    trimzip(q, m, [&](T *, Ele<T *> *nx) { return nx == end; },
             [&](auto *ele) {
                 std::swap(res, ele->data);
-                delete ele;
+                drop(q, ele);
             },
             false);
     return res;
 }
-template <typename T, unsigned N>
-bool rmlast(MtList<T, N> &q, unsigned m = N - 1) noexcept {
+template <typename T, unsigned N, typename A, typename B>
+bool rmlast(MtList<T, N, A, B> &q, unsigned m = N - 1) noexcept {
     Ele<T> *res = nullptr;
-    trimzip(q, m, [](auto, auto *nx) { return nx == nullptr; },
+    Ele<T> *end = bound(q, m > N - 1 ? 0 : m);
+    trimzip(q, m, [&](const auto &, auto *nx) { return nx == end; },
             [&](auto *ele) { res = ele; }, false);
     if (res) {
-        delete res;
+        drop(q, res);
         return true;
     }
     return false;
 }
-template <typename T, typename F, unsigned N>
-Ele<T> *gather(MtList<T, N> &q, unsigned m, F filt) noexcept {
+template <typename T, typename F, unsigned N, typename A, typename B>
+Ele<T> *gather(MtList<T, N, A, B> &q, unsigned m, F filt) noexcept {
     Ele<T> *head = nullptr;
     trim(q, m, filt, [&](auto *ele) {
         ele->next = head;
@@ -0,0 +1,157 @@
+namespace mtl {
+
+// allocation policies for the `Ele` nodes of an `MtList`
+
+struct Heap {
+    template <typename T, typename... V>
+    static Ele<T> *make(V &&... v) noexcept {
+        return new (std::nothrow) Ele<T>(std::forward<V>(v)...);
+    }
+    template <typename T> static void drop(Ele<T> *ele) noexcept {
+        delete ele;
+    }
+};
+
+namespace pool {
+
+static constexpr size_t slabsz = 1 << 16;
+
+struct Free {
+    Free *next;
+};
+struct Mag;
+struct alignas(cacheln) Slab {
+    Mag *owner;
+    Slab *next;
+};
+// per thread cache, `local` is only touched by the owning thread, other
+// threads give nodes back through `remote`.
+struct Mag {
+    alignas(cacheln) std::atomic<Free *> remote;
+    alignas(cacheln) Free *local;
+    char *bump;
+    char *end;
+    Slab *slabs;
+    Mag *next;
+};
+struct Depot {
+    std::mutex lock;
+    Mag *orphans = nullptr;
+};
+template <size_t S> Depot &depot() noexcept {
+    static Depot d;
+    return d;
+}
+template <size_t S> struct Local {
+    Mag *mag = nullptr;
+    ~Local() {
+        if (mag == nullptr) {
+            return;
+        }
+        Depot &d = depot<S>();
+        std::lock_guard<std::mutex> g(d.lock);
+        mag->next = d.orphans;
+        d.orphans = mag;
+    }
+};
+template <size_t S> Local<S> &local() noexcept {
+    static thread_local Local<S> l;
+    return l;
+}
+template <size_t S> Mag *adopt() noexcept {
+    Depot &d = depot<S>();
+    Mag *mag = nullptr;
+    {
+        std::lock_guard<std::mutex> g(d.lock);
+        if ((mag = d.orphans) != nullptr) {
+            d.orphans = mag->next;
+        }
+    }
+    if (mag == nullptr) {
+        if ((mag = new (std::nothrow) Mag) == nullptr) {
+            return nullptr;
+        }
+        mag->remote.store(nullptr, relaxed);
+        mag->local = nullptr;
+        mag->bump = nullptr;
+        mag->end = nullptr;
+        mag->slabs = nullptr;
+    }
+    mag->next = nullptr;
+    return mag;
+}
+template <size_t S> void *carve(Mag *mag) noexcept {
+    static_assert(S % cacheln == 0, "nodes must be cache line sized");
+    static_assert(S <= slabsz - sizeof(Slab), "node too large for the pool");
+    if (unlikely(mag->bump + S > mag->end)) {
+        Slab *slab = static_cast<Slab *>(aligned_alloc(slabsz, slabsz));
+        if (slab == nullptr) {
+            return nullptr;
+        }
+        slab->owner = mag;
+        slab->next = mag->slabs;
+        mag->slabs = slab;
+        mag->bump = reinterpret_cast<char *>(slab) + sizeof(Slab);
+        mag->end = reinterpret_cast<char *>(slab) + slabsz;
+    }
+    void *res = mag->bump;
+    mag->bump += S;
+    return res;
+}
+template <size_t S> void *take() noexcept {
+    Local<S> &l = local<S>();
+    if (unlikely(l.mag == nullptr)) {
+        if ((l.mag = adopt<S>()) == nullptr) {
+            return nullptr;
+        }
+    }
+    Mag *mag = l.mag;
+    Free *res = mag->local;
+    if (unlikely(res == nullptr)) {
+        if ((res = mag->remote.exchange(nullptr, acquire)) == nullptr) {
+            return carve<S>(mag);
+        }
+    }
+    mag->local = res->next;
+    return res;
+}
+template <size_t S> void give(void *raw) noexcept {
+    auto base = reinterpret_cast<uintptr_t>(raw) & ~(uintptr_t)(slabsz - 1);
+    Mag *mag = reinterpret_cast<Slab *>(base)->owner;
+    Free *ele = static_cast<Free *>(raw);
+    if (likely(mag == local<S>().mag)) {
+        ele->next = mag->local;
+        mag->local = ele;
+        return;
+    }
+    Free *head = mag->remote.load(relaxed);
+    do {
+        ele->next = head;
+    } while (!mag->remote.compare_exchange_weak(head, ele, release, relaxed));
+}
+}
+
+struct Pool {
+    template <typename T, typename... V>
+    static Ele<T> *make(V &&... v) noexcept {
+        void *raw = pool::take<sizeof(Ele<T>)>();
+        if (unlikely(raw == nullptr)) {
+            return nullptr;
+        }
+        return new (raw) Ele<T>(std::forward<V>(v)...);
+    }
+    template <typename T> static void drop(Ele<T> *ele) noexcept {
+        ele->~Ele<T>();
+        pool::give<sizeof(Ele<T>)>(ele);
+    }
+};
+
+template <typename T, unsigned N, typename A, typename B, typename... V>
+Ele<T> *make(MtList<T, N, A, B> &, V &&... v) noexcept {
+    return A::template make<T>(std::forward<V>(v)...);
+}
+template <typename T, unsigned N, typename A, typename B>
+void drop(MtList<T, N, A, B> &, Ele<T> *ele) noexcept {
+    A::drop(ele);
+}
+}
@@ -0,0 +1,112 @@
+namespace mtl {
+
+// priority front end of the multiple insertion points list, the `m` entry's
+// segment holds the level `m` data, 0 being the highest; the bit `m` of `occ`
+// is set by the producers once they appended to the level, and only cleared
+// by a consumer which found the level empty while holding its entry, so a non
+// empty level always has its bit set, an empty one might have it set too
+
+template <typename T, unsigned N, typename A = Heap, typename B = Busy>
+struct Prio {
+    static_assert(N <= 64, "must have at most 64 levels");
+    MtList<T, N, A, B> q;
+    alignas(cacheln) std::atomic<uint64_t> occ{0};
+};
+template <typename T, unsigned N, typename A, typename B, typename... V>
+Ele<T> *make(Prio<T, N, A, B> &p, V &&... v) noexcept {
+    return make(p.q, std::forward<V>(v)...);
+}
+template <typename T, unsigned N, typename A, typename B>
+void drop(Prio<T, N, A, B> &p, Ele<T> *ele) noexcept {
+    drop(p.q, ele);
+}
+template <typename T, unsigned N, typename A, typename B>
+void push(Prio<T, N, A, B> &p, unsigned m, Ele<T> *head,
+          Ele<T> *tail) noexcept {
+    if (m > N - 1) {
+        m = 0;
+    }
+    chain(p.q, m, head, tail);
+    p.occ.fetch_or(uint64_t(1) << m, relaxed);
+}
+template <typename T, unsigned N, typename A, typename B>
+void push(Prio<T, N, A, B> &p, unsigned m, Ele<T> *ele) noexcept {
+    Ele<T> *tail = ele;
+    Ele<T> *next;
+    if (unlikely(ele == nullptr)) {
+        return;
+    }
+    while ((next = tail->next.load(relaxed)) != nullptr) {
+        tail = next;
+    }
+    push(p, m, ele, tail);
+}
+// unlinks the first element of the `m` level, or all of them, clearing the
+// level's bit before unlocking its entry if it's left empty
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *take(Prio<T, N, A, B> &p, unsigned m, bool all) noexcept {
+    MtList<T, N, A, B> &q = p.q;
+    Ele<T> *end = bound(q, m);
+    Ele<T> *head = lock(q, m, &q.entry[m]);
+    Ele<T> *prev = head;
+    Ele<T> *curr;
+    if (head == end) {
+        p.occ.fetch_and(~(uint64_t(1) << m), relaxed);
+        unlock(q, &q.entry[m], end, relaxed);
+        return nullptr;
+    }
+    if (!all) {
+        curr = lock(q, m, head);
+        if (curr == end) {
+            setback(q, m, &q.entry[m]);
+            p.occ.fetch_and(~(uint64_t(1) << m), relaxed);
+        }
+        unlock(q, &q.entry[m], curr, release);
+        unlock(q, head, nullptr, relaxed);
+        return head;
+    }
+    setback(q, m, &q.entry[m]);
+    p.occ.fetch_and(~(uint64_t(1) << m), relaxed);
+    unlock(q, &q.entry[m], end, release);
+    curr = head;
+    do {
+        curr = lock(q, m, curr);
+        if (curr == end) {
+            unlock(q, prev, nullptr, relaxed);
+            return head;
+        }
+        unlock(q, prev, curr, relaxed);
+        prev = curr;
+    } while (true);
+}
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *chunk(Prio<T, N, A, B> &p) noexcept {
+    uint64_t occ;
+    Ele<T> *res;
+    while ((occ = p.occ.load(relaxed)) != 0) {
+        if ((res = take(p, __builtin_ctzll(occ), true)) != nullptr) {
+            return res;
+        }
+    }
+    return nullptr;
+}
+template <typename T, unsigned N, typename A, typename B>
+T get(Prio<T, N, A, B> &p) noexcept {
+    uint64_t occ;
+    Ele<T> *ele;
+    T res = {};
+    while ((occ = p.occ.load(relaxed)) != 0) {
+        if ((ele = take(p, __builtin_ctzll(occ), false)) != nullptr) {
+            res = std::move(ele->data);
+            drop(p.q, ele);
+            break;
+        }
+    }
+    return res;
+}
+// the bitmap is only peeked, as `empty` on a `Shard`
+template <typename T, unsigned N, typename A, typename B>
+bool empty(Prio<T, N, A, B> &p) noexcept {
+    return p.occ.load(relaxed) == 0;
+}
+}
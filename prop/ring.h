@@ -0,0 +1,171 @@
+#ifndef RING_H
+#define RING_H
+
+#include "list.h"
+#include "../next/vec.h"
+
+namespace mtl {
+
+// Bounded lock-free queue, with a power of two number of slots kept in a
+// `FixVec`. Every slot carries a sequence number: it's free for the `pos`
+// push when it's equal to `pos`, and full for the `pos` pop when it's equal
+// to `pos + 1`.
+// Notes: `make` must be called before use, `del` frees the slots.
+template <typename T> struct Cell {
+    using Owned = T;
+    std::atomic<size_t> seq;
+    T data;
+};
+void init(Cell<Init> &c) {
+    c.seq.store(0, relaxed);
+    init(c.data);
+}
+void init(Cell<NoInit> &c) {
+    c.seq.store(0, relaxed);
+}
+
+template <typename T> struct Ring {
+    using Owned = T;
+    Padded<size_t> head;
+    Padded<size_t> tail;
+    FixVec<Cell<T>> cells;
+    size_t mask;
+};
+void init(Ring<auto> &r) {
+    init(r.cells);
+    r.head.store(0, relaxed);
+    r.tail.store(0, relaxed);
+    r.mask = 0;
+}
+template <typename T> bool make(Ring<T> &r, const size_t size) {
+    size_t n = 1;
+    while (n < size) {
+        n <<= 1;
+    }
+    if (make(r.cells, n) == false) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        r.cells[i].seq.store(i, relaxed);
+    }
+    r.head.store(0, relaxed);
+    r.tail.store(0, release);
+    r.mask = n - 1;
+    return true;
+}
+
+// claims up to `n` consecutive slots, whose sequence is `pos + off`, moving
+// `at` forward, returns the first claimed position
+template <typename T>
+size_t claim(Ring<T> &r, Padded<size_t> &at, const size_t off,
+             size_t &n) noexcept {
+    size_t pos = at.load(relaxed);
+    intptr_t dif = 0;
+    size_t k;
+    if (unlikely(n == 0)) {
+        return pos;
+    }
+    do {
+        for (k = 0; k < n; ++k) {
+            Cell<T> &c = r.cells.data[(pos + k) & r.mask];
+            if ((dif = (intptr_t)(c.seq.load(acquire) - (pos + k + off)))) {
+                break;
+            }
+        }
+        if (k == 0) {
+            if (dif < 0) {
+                n = 0;
+                return pos;
+            }
+            pos = at.load(relaxed);
+        } else if (at.compare_exchange_weak(pos, pos + k, relaxed, relaxed)) {
+            n = k;
+            return pos;
+        }
+    } while (true);
+}
+
+template <typename T> bool try_push(Ring<T> &r, const T &ele) noexcept {
+    size_t n = 1;
+    size_t pos = claim(r, r.head, 0, n);
+    if (n == 0) {
+        return false;
+    }
+    Cell<T> &c = r.cells.data[pos & r.mask];
+    c.data = ele;
+    c.seq.store(pos + 1, release);
+    return true;
+}
+template <typename T> bool try_push(Ring<T> &r, T &&ele) noexcept {
+    size_t n = 1;
+    size_t pos = claim(r, r.head, 0, n);
+    if (n == 0) {
+        return false;
+    }
+    Cell<T> &c = r.cells.data[pos & r.mask];
+    c.data = std::move(ele);
+    c.seq.store(pos + 1, release);
+    return true;
+}
+template <typename T> bool try_pop(Ring<T> &r, T &ele) noexcept {
+    size_t n = 1;
+    size_t pos = claim(r, r.tail, 1, n);
+    if (n == 0) {
+        return false;
+    }
+    Cell<T> &c = r.cells.data[pos & r.mask];
+    ele = std::move(c.data);
+    c.seq.store(pos + r.mask + 1, release);
+    return true;
+}
+// batch variants, move up to `n` elements with a single claim, returning how
+// many were moved
+template <typename T>
+size_t try_push(Ring<T> &r, const T *src, size_t n) noexcept {
+    size_t pos = claim(r, r.head, 0, n);
+    for (size_t i = 0; i < n; ++i) {
+        Cell<T> &c = r.cells.data[(pos + i) & r.mask];
+        c.data = src[i];
+        c.seq.store(pos + i + 1, release);
+    }
+    return n;
+}
+template <typename T> size_t try_pop(Ring<T> &r, T *dst, size_t n) noexcept {
+    size_t pos = claim(r, r.tail, 1, n);
+    for (size_t i = 0; i < n; ++i) {
+        Cell<T> &c = r.cells.data[(pos + i) & r.mask];
+        dst[i] = std::move(c.data);
+        c.seq.store(pos + i + r.mask + 1, release);
+    }
+    return n;
+}
+
+// `MtList` like interface, `push` fails when the queue is full, `get` returns
+// the default constructed version when it's empty
+template <typename T> bool push(Ring<T> &r, const T &ele) noexcept {
+    return try_push(r, ele);
+}
+template <typename T> bool push(Ring<T> &r, T &&ele) noexcept {
+    return try_push(r, std::move(ele));
+}
+template <typename T> T get(Ring<T> &r) noexcept {
+    T res = {};
+    try_pop(r, res);
+    return res;
+}
+
+template <Del T> void del(Ring<T> &r) {
+    T ele;
+    while (try_pop(r, ele)) {
+        del(ele);
+    }
+    del(r.cells);
+    r.mask = 0;
+}
+template <NoDel T> void del(Ring<T> &r) {
+    del(r.cells);
+    r.mask = 0;
+}
+}
+
+#endif // RING_H
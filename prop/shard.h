@@ -0,0 +1,96 @@
+namespace mtl {
+
+// sharded front end of the multiple insertion points list, each thread is
+// bound to the `tid() % N` entry
+
+inline unsigned tid() noexcept {
+    static std::atomic<unsigned> ticket{0};
+    static thread_local unsigned id = ticket.fetch_add(1, relaxed);
+    return id;
+}
+
+template <typename T, unsigned N, typename A = Heap, typename B = Busy>
+struct Shard {
+    MtList<T, N, A, B> q;
+};
+template <typename T, unsigned N, typename A, typename B>
+unsigned home(Shard<T, N, A, B> &) noexcept {
+    return tid() % N;
+}
+template <typename T, unsigned N, typename A, typename B, typename... V>
+Ele<T> *make(Shard<T, N, A, B> &s, V &&... v) noexcept {
+    return make(s.q, std::forward<V>(v)...);
+}
+template <typename T, unsigned N, typename A, typename B>
+void drop(Shard<T, N, A, B> &s, Ele<T> *ele) noexcept {
+    drop(s.q, ele);
+}
+template <typename T, unsigned N, typename A, typename B>
+void push(Shard<T, N, A, B> &s, Ele<T> *head, Ele<T> *tail) noexcept {
+    chain(s.q, home(s), head, tail);
+}
+template <typename T, unsigned N, typename A, typename B>
+void push(Shard<T, N, A, B> &s, Ele<T> *ele) noexcept {
+    chain(s.q, home(s), ele, ele);
+}
+// the entry's link is only peeked, a locked entry is taken as not empty
+template <typename T, unsigned N, typename A, typename B>
+bool empty(Shard<T, N, A, B> &s, unsigned m) noexcept {
+    return s.q.entry[m].next.load(relaxed) == bound(s.q, m);
+}
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *chunk(Shard<T, N, A, B> &s) noexcept {
+    unsigned m = home(s);
+    Ele<T> *res;
+    if ((res = chunk(s.q, m)) != nullptr) {
+        return res;
+    }
+    for (unsigned i = 1; i < N; ++i) {
+        unsigned v = (m + i) % N;
+        if (empty(s, v)) {
+            continue;
+        }
+        if ((res = chunk(s.q, v)) != nullptr) {
+            return res;
+        }
+    }
+    return nullptr;
+}
+// unlinks the first element of the `m` segment, without walking past it
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *take(Shard<T, N, A, B> &s, unsigned m) noexcept {
+    MtList<T, N, A, B> &q = s.q;
+    Ele<T> *end = bound(q, m);
+    Ele<T> *head = lock(q, m, &q.entry[m]);
+    Ele<T> *next;
+    if (head == end) {
+        unlock(q, &q.entry[m], end, relaxed);
+        return nullptr;
+    }
+    next = lock(q, m, head);
+    if (next == end) {
+        setback(q, m, head, &q.entry[m]);
+    }
+    unlock(q, &q.entry[m], next, release);
+    unlock(q, head, nullptr, relaxed);
+    return head;
+}
+template <typename T, unsigned N, typename A, typename B>
+T get(Shard<T, N, A, B> &s) noexcept {
+    unsigned m = home(s);
+    Ele<T> *ele;
+    T res = {};
+    for (unsigned i = 0; i < N; ++i) {
+        unsigned v = (m + i) % N;
+        if (i != 0 && empty(s, v)) {
+            continue;
+        }
+        if ((ele = take(s, v)) != nullptr) {
+            res = std::move(ele->data);
+            drop(s.q, ele);
+            break;
+        }
+    }
+    return res;
+}
+}
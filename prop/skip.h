@@ -0,0 +1,334 @@
+namespace mtl {
+
+// Ordered list, every element is a tower of links: the first one is the `Ele`
+// link, ordering all the elements, the `k`-th skips ahead on the `k`-th level,
+// linking about a fourth of the elements of the level below. Each link is
+// locked as the `Ele` one, pointing to its own element, and traversals lock
+// hand over hand, from the head's top level down, never going up.
+// Elements are linked top down, their links staying locked until they're
+// linked on that level, and they're removed in two steps: claimed on the
+// bottom level, then unlinked top down, their links staying locked.
+// `tail` leaves the claimed elements out, to their claimers.
+
+namespace skip {
+
+enum : unsigned { linking, linked, claimed };
+
+// geometric height, with a 1/4 chance to grow one level
+inline unsigned draw(unsigned max) noexcept {
+    static thread_local uint64_t x = reinterpret_cast<uintptr_t>(&x) | 1;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    unsigned h = 1;
+    for (uint64_t r = x; h < max && (r & 3) == 0; r >>= 2) {
+        ++h;
+    }
+    return h;
+}
+}
+
+template <typename T, unsigned H> struct Tower : Ele<T> {
+    std::atomic<Ele<T> *> up[H - 1];
+    std::atomic<unsigned> state;
+    unsigned height;
+    Tower *rest;
+    template <typename... V>
+    Tower(unsigned h, V &&... v) noexcept
+        : Ele<T>(std::forward<V>(v)...), state{skip::linking}, height{h},
+          rest{nullptr} {
+        static_assert(H > 1, "must have at least two levels");
+        for (auto &l : up) {
+            l.store(nullptr, relaxed);
+        }
+    }
+};
+template <typename T, typename C = std::less<>, unsigned H = 12,
+          typename B = Busy>
+struct Skip {
+    Tower<T, H> head{H};
+    std::atomic<unsigned> level{1};
+    C less;
+};
+
+template <typename T, unsigned H>
+std::atomic<Ele<T> *> &link(Tower<T, H> *t, unsigned i) noexcept {
+    return i == 0 ? t->next : t->up[i - 1];
+}
+template <typename T, unsigned H> Tower<T, H> *tower(Ele<T> *ele) noexcept {
+    return static_cast<Tower<T, H> *>(ele);
+}
+template <typename T, typename C, unsigned H, typename B>
+Ele<T> *lock(Skip<T, C, H, B> &, Tower<T, H> *t, unsigned i) noexcept {
+    auto &l = link(t, i);
+    Ele<T> *res;
+    size_t spin = 0;
+    while ((res = l.exchange(t, consume)) == t) {
+        B::wait(l, (Ele<T> *)t, spin++);
+    }
+    return res;
+}
+template <typename T, typename C, unsigned H, typename B>
+void unlock(Skip<T, C, H, B> &, Tower<T, H> *t, unsigned i,
+            typename std::atomic<Ele<T> *>::value_type next,
+            std::memory_order order) noexcept {
+    auto &l = link(t, i);
+    l.store(next, order);
+    B::wake(l);
+}
+// raises the list's level to at least `h`, returns it
+template <typename T, typename C, unsigned H, typename B>
+unsigned raise(Skip<T, C, H, B> &s, unsigned h) noexcept {
+    unsigned l = s.level.load(relaxed);
+    while (l < h && !s.level.compare_exchange_weak(l, h, relaxed)) {
+        continue;
+    }
+    return l < h ? h : l;
+}
+
+template <typename T, typename C, unsigned H, typename B, typename... V>
+Ele<T> *make(Skip<T, C, H, B> &, V &&... v) noexcept {
+    return new (std::nothrow)
+        Tower<T, H>(skip::draw(H), std::forward<V>(v)...);
+}
+template <typename T, typename C, unsigned H, typename B>
+void drop(Skip<T, C, H, B> &, Ele<T> *ele) noexcept {
+    delete tower<T, H>(ele);
+}
+
+// from the `top` level of the head, moves right while `before` holds for the
+// level and the next element, and down, linking the left element to what `at`
+// returns for its link on that level; returns the left element of the bottom
+// level, still locked, setting `next` to its link
+template <typename T, typename C, unsigned H, typename B, typename F,
+          typename L>
+Tower<T, H> *descend(Skip<T, C, H, B> &s, unsigned top, F before, L at,
+                     Ele<T> *&next) noexcept {
+    Tower<T, H> *pred = &s.head;
+    Ele<T> *nx;
+    next = lock(s, pred, top);
+    for (unsigned i = top;; --i) {
+        while (next != nullptr && before(i, next)) {
+            nx = lock(s, tower<T, H>(next), i);
+            unlock(s, pred, i, next, release);
+            pred = tower<T, H>(next);
+            next = nx;
+        }
+        if (i == 0) {
+            return pred;
+        }
+        next = at(i, next);
+        nx = lock(s, pred, i - 1);
+        unlock(s, pred, i, next, release);
+        next = nx;
+    }
+}
+// claims the first linked element of the bottom level matching `match`, after
+// the ones for which `before` holds
+template <typename T, typename C, unsigned H, typename B, typename F,
+          typename M>
+Tower<T, H> *claim(Skip<T, C, H, B> &s, unsigned top, F before,
+                   M match) noexcept {
+    Ele<T> *next;
+    Ele<T> *nx;
+    Tower<T, H> *pred =
+        descend(s, top, before, [](unsigned, Ele<T> *n) { return n; }, next);
+    while (next != nullptr && match(next)) {
+        Tower<T, H> *t = tower<T, H>(next);
+        unsigned st = skip::linked;
+        if (t->state.compare_exchange_strong(st, skip::claimed, relaxed)) {
+            unlock(s, pred, 0, next, release);
+            return t;
+        }
+        nx = lock(s, t, 0);
+        unlock(s, pred, 0, next, release);
+        pred = t;
+        next = nx;
+    }
+    unlock(s, pred, 0, next, release);
+    return nullptr;
+}
+// unlinks the claimed `t`, unless `tail` left it out, above its height the
+// walk stops before its equals, as they might follow it
+template <typename T, typename C, unsigned H, typename B>
+void unlink(Skip<T, C, H, B> &s, Tower<T, H> *t) noexcept {
+    Ele<T> *next;
+    Tower<T, H> *pred = descend(
+        s, raise(s, t->height) - 1,
+        [&](unsigned i, Ele<T> *e) {
+            if (i >= t->height) {
+                return s.less(e->data, t->data);
+            }
+            return e != t && !s.less(t->data, e->data);
+        },
+        [&](unsigned i, Ele<T> *nx) { return nx == t ? lock(s, t, i) : nx; },
+        next);
+    unlock(s, pred, 0, next == t ? lock(s, t, 0) : next, release);
+}
+
+template <typename T, typename C, unsigned H, typename B>
+void insert(Skip<T, C, H, B> &s, Ele<T> *ele) noexcept {
+    Tower<T, H> *t = tower<T, H>(ele);
+    Ele<T> *next;
+    for (unsigned i = 0; i < t->height; ++i) {
+        link(t, i).store(t, relaxed);
+    }
+    Tower<T, H> *pred = descend(
+        s, raise(s, t->height) - 1,
+        [&](unsigned, Ele<T> *e) { return !s.less(t->data, e->data); },
+        [&](unsigned i, Ele<T> *nx) {
+            if (i >= t->height) {
+                return nx;
+            }
+            unlock(s, t, i, nx, release);
+            return ele;
+        },
+        next);
+    t->state.store(skip::linked, relaxed);
+    unlock(s, t, 0, next, release);
+    unlock(s, pred, 0, ele, release);
+}
+template <typename T, typename C, unsigned H, typename B, typename K,
+          typename F>
+bool find(Skip<T, C, H, B> &s, const K &key, F f) noexcept {
+    Ele<T> *next;
+    Ele<T> *nx;
+    Tower<T, H> *pred =
+        descend(s, s.level.load(relaxed) - 1,
+                [&](unsigned, Ele<T> *e) { return s.less(e->data, key); },
+                [](unsigned, Ele<T> *n) { return n; }, next);
+    while (next != nullptr && !s.less(key, next->data)) {
+        Tower<T, H> *t = tower<T, H>(next);
+        nx = lock(s, t, 0);
+        unlock(s, pred, 0, next, release);
+        if (t->state.load(relaxed) == skip::linked) {
+            f(t->data);
+            unlock(s, t, 0, nx, release);
+            return true;
+        }
+        pred = t;
+        next = nx;
+    }
+    unlock(s, pred, 0, next, release);
+    return false;
+}
+// the data is swapped out, as the `T *` elements own it
+template <typename T, typename C, unsigned H, typename B, typename K>
+T get(Skip<T, C, H, B> &s, const K &key) noexcept {
+    T res = {};
+    Tower<T, H> *t =
+        claim(s, s.level.load(relaxed) - 1,
+              [&](unsigned, Ele<T> *e) { return s.less(e->data, key); },
+              [&](Ele<T> *e) { return !s.less(key, e->data); });
+    if (t != nullptr) {
+        unlink(s, t);
+        std::swap(res, t->data);
+        drop(s, t);
+    }
+    return res;
+}
+template <typename T, typename C, unsigned H, typename B>
+T get(Skip<T, C, H, B> &s) noexcept {
+    T res = {};
+    Tower<T, H> *t = claim(s, 0, [](unsigned, Ele<T> *) { return false; },
+                           [](Ele<T> *) { return true; });
+    if (t != nullptr) {
+        unlink(s, t);
+        std::swap(res, t->data);
+        drop(s, t);
+    }
+    return res;
+}
+template <typename T, typename C, unsigned H, typename B, typename K>
+bool rm(Skip<T, C, H, B> &s, const K &key) noexcept {
+    Tower<T, H> *t =
+        claim(s, s.level.load(relaxed) - 1,
+              [&](unsigned, Ele<T> *e) { return s.less(e->data, key); },
+              [&](Ele<T> *e) { return !s.less(key, e->data); });
+    if (t == nullptr) {
+        return false;
+    }
+    unlink(s, t);
+    drop(s, t);
+    return true;
+}
+template <typename T, typename C, unsigned H, typename B, typename F>
+Ele<T> *gather(Skip<T, C, H, B> &s, F filt) noexcept {
+    Tower<T, H> *pred = &s.head;
+    Tower<T, H> *claimed = nullptr;
+    Tower<T, H> *t;
+    Ele<T> *curr = lock(s, pred, 0);
+    Ele<T> *next;
+    Ele<T> *head = nullptr;
+    while (curr != nullptr) {
+        t = tower<T, H>(curr);
+        next = lock(s, t, 0);
+        unsigned st = skip::linked;
+        if (filt(t->data) &&
+            t->state.compare_exchange_strong(st, skip::claimed, relaxed)) {
+            t->rest = claimed;
+            claimed = t;
+        }
+        unlock(s, pred, 0, curr, release);
+        pred = t;
+        curr = next;
+    }
+    unlock(s, pred, 0, nullptr, release);
+    while (claimed != nullptr) {
+        t = claimed;
+        claimed = t->rest;
+        unlink(s, t);
+        t->next.store(head, relaxed);
+        head = t;
+    }
+    return head;
+}
+// with the head locked on every level, each level is walked to the end, so
+// that no operation is left on the detached elements
+template <typename T, typename C, unsigned H, typename B>
+Ele<T> *tail(Skip<T, C, H, B> &s) noexcept {
+    Ele<T> *first[H];
+    Tower<T, H> *prev;
+    Tower<T, H> *t;
+    Ele<T> *curr;
+    Ele<T> *next;
+    Ele<T> *head = nullptr;
+    for (unsigned i = H; i-- > 0;) {
+        first[i] = lock(s, &s.head, i);
+    }
+    for (unsigned i = H; i-- > 1;) {
+        prev = nullptr;
+        for (curr = first[i]; curr != nullptr; curr = next) {
+            next = lock(s, tower<T, H>(curr), i);
+            if (prev != nullptr) {
+                unlock(s, prev, i, curr, release);
+            }
+            prev = tower<T, H>(curr);
+        }
+        if (prev != nullptr) {
+            unlock(s, prev, i, nullptr, release);
+        }
+    }
+    prev = nullptr;
+    for (curr = first[0]; curr != nullptr; curr = next) {
+        t = tower<T, H>(curr);
+        next = lock(s, t, 0);
+        if (t->state.load(relaxed) == skip::claimed) {
+            continue;
+        }
+        if (prev != nullptr) {
+            unlock(s, prev, 0, curr, release);
+        } else {
+            head = curr;
+        }
+        prev = t;
+    }
+    if (prev != nullptr) {
+        unlock(s, prev, 0, nullptr, release);
+    }
+    for (unsigned i = 0; i < H; ++i) {
+        unlock(s, &s.head, i, nullptr, release);
+    }
+    return head;
+}
+}
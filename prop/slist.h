@@ -4,13 +4,13 @@ template <typename T> struct alignas(cacheln) Ele {
     std::atomic<Ele<T> *> next;
     T data;
     Ele() noexcept { next = nullptr; }
-    Ele(T &&value) noexcept : data{std::move(value)} {
+    Ele(T &&value) noexcept : next{nullptr}, data{std::move(value)} {
         static_assert(std::is_nothrow_move_constructible<T>(),
                       "move cannot throw");
         static_assert(std::is_default_constructible<T>(),
                       "must be default constructable");
     }
-    Ele(const T &value) noexcept : data{value} {
+    Ele(const T &value) noexcept : next{nullptr}, data{value} {
         static_assert(std::is_nothrow_copy_constructible<T>(),
                       "copy cannot throw");
     }
@@ -22,56 +22,106 @@ template <typename T> struct alignas(cacheln) Ele<T *> {
         data = nullptr;
         next = nullptr;
     }
-    Ele(T *value) noexcept : data{value} {}
+    Ele(T *value) noexcept : next{nullptr}, data{value} {}
     ~Ele() noexcept { delete data; }
 };
-template <typename T, unsigned N = 1> struct MtList {
+template <typename T, unsigned N = 1, typename A = Heap, typename B = Busy>
+struct MtList {
     Ele<T> entry[N];
+    Padded<Ele<T> *> back[N];
+#ifdef MTL_SPINSTAT
+    unsigned stat = spinslot(N);
+#endif
     MtList() {
         static_assert(N > 0, "must have at least one entry");
         for (unsigned i = 0; i < N - 1; ++i) {
             entry[i].next = &entry[i + 1];
         }
         entry[N - 1].next = nullptr;
+        for (unsigned i = 0; i < N; ++i) {
+            back[i] = &entry[i];
+        }
     }
 };
-template <typename T> void chain(MtList<T, 1> &q, Ele<T> *ele) noexcept {
-    Ele<T> *curr = &q.entry[0];
-    Ele<T> *prev = curr;
-    Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
+// the `back` pointer of each entry is locked by swapping in nullptr, it's
+// taken after the element locks by whoever changes the last element, and
+// before them by `lockback`, which for this reason only tries to lock the last
+// element, backing off on failure.
+template <typename T, unsigned N, typename A, typename B>
+void setback(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele) noexcept {
+    size_t spin = 0;
+    while (q.back[m].exchange(nullptr, consume) == nullptr) {
+        B::wait(q.back[m], (Ele<T> *)nullptr, spin++);
     }
-    while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
+    spinstat(q, m, spin);
+    unback(q, m, ele, release);
+}
+// moves `back` from `last` to `ele`, leaving it if it's not on `last` anymore,
+// the chain ending with `last` having been taken by `tail` or `chunk`; the
+// caller keeps `last` locked, so it can't be chained back meanwhile
+template <typename T, unsigned N, typename A, typename B>
+void setback(MtList<T, N, A, B> &q, unsigned m, Ele<T> *last,
+             Ele<T> *ele) noexcept {
+    Ele<T> *back;
+    size_t spin = 0;
+    while ((back = q.back[m].exchange(nullptr, consume)) == nullptr) {
+        B::wait(q.back[m], (Ele<T> *)nullptr, spin++);
+    }
+    spinstat(q, m, spin);
+    unback(q, m, back == last ? ele : back, release);
+}
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *lockback(MtList<T, N, A, B> &q, unsigned m) noexcept {
+    Ele<T> *last;
+    size_t spin = 0;
+    do {
+        while ((last = q.back[m].exchange(nullptr, consume)) == nullptr) {
+            B::wait(q.back[m], (Ele<T> *)nullptr, spin++);
         }
-        prev->next.store(curr, relaxed);
-        prev = curr;
-        curr = next;
+        if (last->next.exchange(last, consume) != last) {
+            spinstat(q, m, spin);
+            return last;
+        }
+        unback(q, m, last, release);
+        B::wait(q.back[m], (Ele<T> *)nullptr, spin++);
+    } while (true);
+}
+template <typename T, typename A, typename B>
+void chain(MtList<T, 1, A, B> &q, Ele<T> *head, Ele<T> *tail) noexcept {
+    Ele<T> *last = lockback(q, 0);
+    tail->next.store(nullptr, relaxed);
+    unlock(q, last, head, release);
+    unback(q, 0, tail, release);
+}
+template <typename T, typename A, typename B>
+void chain(MtList<T, 1, A, B> &q, Ele<T> *ele) noexcept {
+    Ele<T> *tail = ele;
+    Ele<T> *next;
+    if (unlikely(ele == nullptr)) {
+        return;
     }
-    prev->next.store(ele, relaxed);
-    return;
+    while ((next = tail->next.load(relaxed)) != nullptr) {
+        tail = next;
+    }
+    chain(q, ele, tail);
 }
-template <typename T, typename P, typename F>
-void trim(MtList<T, 1> &q, F filt, P pred, bool cont = true) noexcept {
+template <typename T, typename P, typename F, typename A, typename B>
+void trim(MtList<T, 1, A, B> &q, F filt, P pred, bool cont = true) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
     Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, 0, curr);
     while (likely(curr)) {
-        next = curr;
         auto cond = filt(curr->data);
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, 0, curr);
         if (unlikely(cond)) {
+            if (next == nullptr) {
+                setback(q, 0, curr, prev);
+            }
+            unlock(q, curr, next, release);
             pred(curr);
             if (!cont) {
-                prev->next.store(next, relaxed);
+                unlock(q, prev, next, release);
                 return;
             }
             curr = next;
@@ -79,31 +129,30 @@ void trim(MtList<T, 1> &q, F filt, P pred, bool cont = true) noexcept {
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, release);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, release);
 }
-template <typename T, typename P, typename F>
-void trimzip(MtList<T, 1> &q, F filt, P pred, bool cont = true) noexcept {
+template <typename T, typename P, typename F, typename A, typename B>
+void trimzip(MtList<T, 1, A, B> &q, F filt, P pred, bool cont = true) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
     Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, 0, curr);
     while (likely(curr)) {
-        next = curr;
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, 0, curr);
         auto cond = filt(curr->data, next);
         if (unlikely(cond)) {
+            if (next == nullptr) {
+                setback(q, 0, curr, prev);
+            }
+            unlock(q, curr, next, release);
             pred(curr);
             if (!cont) {
-                prev->next.store(next, relaxed);
+                unlock(q, prev, next, release);
                 return;
             }
             curr = next;
@@ -111,156 +160,163 @@ void trimzip(MtList<T, 1> &q, F filt, P pred, bool cont = true) noexcept {
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, release);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, release);
 }
-template <typename T, typename P>
-bool insert(MtList<T, 1> &q, Ele<T> *head, Ele<T> *tail, P pred) noexcept {
+template <typename T, typename P, typename A, typename B>
+bool insert(MtList<T, 1, A, B> &q, Ele<T> *head, Ele<T> *tail,
+            P pred) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
     Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, 0, curr);
     while (likely(curr)) {
-        next = curr;
         auto cond = pred(prev, curr);
-        while ((next = next->next.exchange(next, consume)) == curr) {
-            continue;
-        }
+        next = lock(q, 0, curr);
         if (unlikely(cond)) {
             tail->next.store(next, relaxed);
-            curr->next.store(head, release);
+            if (next == nullptr) {
+                setback(q, 0, curr, tail);
+            }
+            unlock(q, curr, head, release);
+            unlock(q, prev, curr, release);
             return true;
         } else {
             if (likely(next)) {
                 prefetch(next->data);
             }
-            prev->next.store(curr, relaxed);
+            unlock(q, prev, curr, release);
             prev = curr;
             curr = next;
         }
     }
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, release);
     return false;
 }
-template <typename T, typename P>
-bool insert(MtList<T, 1> &q, Ele<T> *ele, P pred) noexcept {
+template <typename T, typename P, typename A, typename B>
+bool insert(MtList<T, 1, A, B> &q, Ele<T> *ele, P pred) noexcept {
     return insert(q, ele, ele, pred);
 }
-template <typename T, typename P>
-bool push(MtList<T, 1> &q, Ele<T> *head, Ele<T> *tail, P pred) noexcept {
+template <typename T, typename P, typename A, typename B>
+bool push(MtList<T, 1, A, B> &q, Ele<T> *head, Ele<T> *tail, P pred) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
     Ele<T> *next;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, 0, curr);
     do {
         auto cond = pred(curr);
         if (unlikely(cond)) {
             tail->next.store(curr, relaxed);
-            prev->next.store(head, release);
-           return true;
+            if (curr == nullptr) {
+                setback(q, 0, prev, tail);
+            }
+            unlock(q, prev, head, release);
+            return true;
         } else {
             if ((next = curr) == nullptr) {
                 break;
             } else {
                 prefetch(next->data);
             }
-            while ((next = next->next.exchange(next, consume)) == curr) {
-                continue;
-            }
-            prev->next.store(curr, relaxed);
+            next = lock(q, 0, curr);
+            unlock(q, prev, curr, release);
             prev = curr;
             curr = next;
         }
     } while(true);
-    prev->next.store(nullptr, relaxed);
+    unlock(q, prev, nullptr, release);
     return false;
 }
-template <typename T, typename P>
-bool push(MtList<T, 1> &q, Ele<T> *ele, P pred) noexcept {
+template <typename T, typename P, typename A, typename B>
+bool push(MtList<T, 1, A, B> &q, Ele<T> *ele, P pred) noexcept {
     return push(q, ele, ele, pred);
 }
 
-template <typename T>
-void push(MtList<T, 1> &q, Ele<T> *head, Ele<T> *tail) noexcept {
+template <typename T, typename A, typename B>
+void push(MtList<T, 1, A, B> &q, Ele<T> *head, Ele<T> *tail) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
+    curr = lock(q, 0, curr);
     tail->next.store(curr, relaxed);
-    prev->next.store(head, release);
+    if (curr == nullptr) {
+        setback(q, 0, prev, tail);
+    }
+    unlock(q, prev, head, release);
 }
-template <typename T> void push(MtList<T, 1> &q, Ele<T> *ele) noexcept {
+template <typename T, typename A, typename B>
+void push(MtList<T, 1, A, B> &q, Ele<T> *ele) noexcept {
     push(q, ele, ele);
 }
-template <typename T, typename F> T *get(MtList<T *, 1> &q, F filt) noexcept {
+template <typename T, typename F, typename A, typename B>
+T *get(MtList<T *, 1, A, B> &q, F filt) noexcept {
     T *res = nullptr;
     trim(q, filt,
          [&](auto *ele) {
              std::swap(res, ele->data);
-             delete ele;
+             drop(q, ele);
          },
          false);
     return res;
 }
-template <typename T, typename F> T get(MtList<T, 1> &q, F filt) noexcept {
+template <typename T, typename F, typename A, typename B>
+T get(MtList<T, 1, A, B> &q, F filt) noexcept {
     T res = {};
     trim(q, filt,
          [&](auto *ele) {
              res = std::move(ele->data);
-             delete ele;
+             drop(q, ele);
          },
          false);
     return res;
 }
-template <typename T, typename F> size_t rm(MtList<T, 1> &q, F filt) noexcept {
+template <typename T, typename F, typename A, typename B>
+size_t rm(MtList<T, 1, A, B> &q, F filt) noexcept {
     size_t n = 0;
     trim(q, filt, [&](auto *ele) {
-        delete ele;
+        drop(q, ele);
         ++n;
     });
     return n;
 }
-template <typename T> T last(MtList<T, 1> &q) noexcept {
+template <typename T, typename A, typename B>
+T last(MtList<T, 1, A, B> &q) noexcept {
     T res = {};
     trimzip(q, [](T, Ele<T> *nx) { return nx == nullptr; },
             [&](auto *ele) {
                 res = std::move(ele->data);
-                delete ele;
+                drop(q, ele);
             },
             false);
     return res;
 }
-template <typename T> T *last(MtList<T *, 1> &q) noexcept {
+template <typename T, typename A, typename B>
+T *last(MtList<T *, 1, A, B> &q) noexcept {
     T *res = nullptr;
     trimzip(q, [](T, Ele<T> *nx) { return nx == nullptr; },
             [&](auto *ele) {
                 std::swap(res, ele->data);
-                delete ele;
+                drop(q, ele);
             },
             false);
     return res;
 }
-template <typename T> bool rmlast(MtList<T, 1> &q) noexcept {
+template <typename T, typename A, typename B>
+bool rmlast(MtList<T, 1, A, B> &q) noexcept {
     Ele<T> *res = nullptr;
     trimzip(q, [](auto, auto *nx) { return nx == nullptr; },
             [&](auto *ele) { res = ele; }, false);
     if (res) {
-        delete res;
+        drop(q, res);
         return true;
     }
     return false;
 }
-template <typename T, typename F>
-Ele<T> *gather(MtList<T, 1> &q, F filt) noexcept {
+template <typename T, typename F, typename A, typename B>
+Ele<T> *gather(MtList<T, 1, A, B> &q, F filt) noexcept {
     Ele<T> *head = nullptr;
     trim(q, filt, [&](auto *ele) {
         ele->next = head;
@@ -268,29 +324,63 @@ Ele<T> *gather(MtList<T, 1> &q, F filt) noexcept {
     });
     return head;
 }
-template <typename T> Ele<T> *tail(MtList<T, 1> &q) noexcept {
+template <typename T, typename A, typename B>
+Ele<T> *tail(MtList<T, 1, A, B> &q) noexcept {
     Ele<T> *curr = &q.entry[0];
     Ele<T> *prev = curr;
     Ele<T> *head;
-    while ((curr = curr->next.exchange(curr, consume)) == prev) {
-        continue;
-    }
-    q.entry[0].next.store(nullptr, relaxed);
-    head = curr;
-    prev = curr;
+    curr = lock(q, 0, curr);
     if (curr == nullptr) {
+        unlock(q, &q.entry[0], nullptr, release);
         return nullptr;
     }
+    setback(q, 0, &q.entry[0]);
+    unlock(q, &q.entry[0], nullptr, release);
+    head = curr;
+    prev = curr;
     do {
-        while ((curr = curr->next.exchange(curr, consume)) == prev) {
-            continue;
-        }
+        curr = lock(q, 0, curr);
         if (curr == nullptr) {
-            prev->next.store(nullptr, relaxed);
+            unlock(q, prev, nullptr, release);
             return head;
         }
-        prev->next.store(curr, relaxed);
+        unlock(q, prev, curr, release);
         prev = curr;
     } while (true);
 }
+
+// read only walks, they wait on the locked elements without locking them, the
+// removed elements being unlocked to their successor
+template <typename T, typename F, typename A, typename B>
+void for_each(MtList<T, 1, Epoch<A>, B> &q, F f) noexcept {
+    epoch::Guard g;
+    Ele<T> *curr = peek(q, &q.entry[0]);
+    Ele<T> *next;
+    while (curr != nullptr) {
+        next = peek(q, curr);
+        if (likely(next)) {
+            prefetch(next->data);
+        }
+        f(static_cast<const T &>(curr->data));
+        curr = next;
+    }
+}
+template <typename T, typename F, typename P, typename A, typename B>
+bool find(MtList<T, 1, Epoch<A>, B> &q, F filt, P f) noexcept {
+    epoch::Guard g;
+    for (Ele<T> *curr = peek(q, &q.entry[0]); curr != nullptr;
+         curr = peek(q, curr)) {
+        if (filt(static_cast<const T &>(curr->data))) {
+            f(static_cast<const T &>(curr->data));
+            return true;
+        }
+    }
+    return false;
+}
+template <typename T, typename F, typename A, typename B>
+size_t count(MtList<T, 1, Epoch<A>, B> &q, F filt) noexcept {
+    size_t n = 0;
+    for_each(q, [&](const T &data) { n += filt(data) ? 1 : 0; });
+    return n;
+}
 }
@@ -0,0 +1,200 @@
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+namespace mtl {
+
+// element locking, the link of a locked element points to itself
+
+// Wait policies, what a thread does while a lock word it needs holds
+// `locked`, `spin` being the number of failed attempts so far, and what an
+// unlocker does to wake it up:
+// `Busy` retries right away, `Pause` issues a spin loop hint, `Backoff` waits
+// exponentially longer, up to 1024 hints, and `Park` sleeps on a futex after
+// a short spin, for oversubscribed machines.
+struct Busy {
+    template <typename X>
+    static void wait(std::atomic<X> &, X, size_t) noexcept {}
+    template <typename X> static void wake(std::atomic<X> &) noexcept {}
+};
+struct Pause {
+    template <typename X>
+    static void wait(std::atomic<X> &, X, size_t) noexcept {
+        relax();
+    }
+    template <typename X> static void wake(std::atomic<X> &) noexcept {}
+};
+struct Backoff {
+    template <typename X>
+    static void wait(std::atomic<X> &, X, size_t spin) noexcept {
+        for (size_t i = (size_t)1 << (spin < 10 ? spin : 10); i > 0; --i) {
+            relax();
+        }
+    }
+    template <typename X> static void wake(std::atomic<X> &) noexcept {}
+};
+
+namespace park {
+
+static constexpr size_t spins = 128;
+static constexpr size_t slots = 64;
+
+// the lock words are hashed to a fixed set of futexes, `seq` is bumped by
+// every wake that finds waiters
+struct alignas(cacheln) Slot {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> waiters;
+};
+inline Slot &slot(const void *word) noexcept {
+    static Slot lot[slots];
+    auto h = reinterpret_cast<uintptr_t>(word) / sizeof(void *);
+    return lot[(h ^ (h >> 6)) % slots];
+}
+}
+
+struct Park {
+    template <typename X>
+    static void wait(std::atomic<X> &word, X locked, size_t spin) noexcept {
+        if (likely(spin < park::spins)) {
+            relax();
+            return;
+        }
+#ifdef __linux__
+        park::Slot &s = park::slot(&word);
+        s.waiters.fetch_add(1);
+        uint32_t seq = s.seq.load();
+        if (word.load() == locked) {
+            syscall(SYS_futex, &s.seq, FUTEX_WAIT_PRIVATE, seq, nullptr,
+                    nullptr, 0);
+        }
+        s.waiters.fetch_sub(1, relaxed);
+#else
+        (void)word;
+        (void)locked;
+        sched_yield();
+#endif
+    }
+    template <typename X> static void wake(std::atomic<X> &word) noexcept {
+#ifdef __linux__
+        park::Slot &s = park::slot(&word);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (unlikely(s.waiters.load(relaxed) != 0)) {
+            s.seq.fetch_add(1, relaxed);
+            syscall(SYS_futex, &s.seq, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+                    nullptr, 0);
+        }
+#else
+        (void)word;
+#endif
+    }
+};
+
+// spin statistics of an entry: locks acquired, failed exchanges and longest
+// wait, kept in the bench.h `counters` when MTL_SPINSTAT is defined
+struct Spin {
+    size_t acquires;
+    size_t spins;
+    size_t longest;
+};
+
+#ifdef MTL_SPINSTAT
+inline unsigned spinslot(unsigned n) noexcept {
+    static std::atomic<unsigned> cursor{0};
+    return cursor.fetch_add(3 * n, relaxed);
+}
+inline std::atomic<size_t> &spincount(unsigned slot, unsigned m,
+                                      unsigned k) noexcept {
+    constexpr auto n = sizeof(counters) / sizeof(*counters);
+    return counters[(slot + 3 * m + k) % n].data;
+}
+template <typename T, unsigned N, typename A, typename B>
+void spinstat(MtList<T, N, A, B> &q, unsigned m, size_t spin) noexcept {
+    spincount(q.stat, m, 0).fetch_add(1, relaxed);
+    if (likely(spin == 0)) {
+        return;
+    }
+    spincount(q.stat, m, 1).fetch_add(spin, relaxed);
+    auto &longest = spincount(q.stat, m, 2);
+    size_t prev = longest.load(relaxed);
+    while (spin > prev && !longest.compare_exchange_weak(prev, spin, relaxed)) {
+        continue;
+    }
+}
+template <typename T, unsigned N, typename A, typename B>
+Spin snapshot(MtList<T, N, A, B> &q, unsigned m) noexcept {
+    return {spincount(q.stat, m, 0).load(relaxed),
+            spincount(q.stat, m, 1).load(relaxed),
+            spincount(q.stat, m, 2).load(relaxed)};
+}
+template <typename T, unsigned N, typename A, typename B>
+void reset(MtList<T, N, A, B> &q) noexcept {
+    for (unsigned m = 0; m < N; ++m) {
+        for (unsigned k = 0; k < 3; ++k) {
+            spincount(q.stat, m, k).store(0, relaxed);
+        }
+    }
+}
+#else
+template <typename T, unsigned N, typename A, typename B>
+void spinstat(MtList<T, N, A, B> &, unsigned, size_t) noexcept {}
+template <typename T, unsigned N, typename A, typename B>
+Spin snapshot(MtList<T, N, A, B> &, unsigned) noexcept {
+    return {0, 0, 0};
+}
+template <typename T, unsigned N, typename A, typename B>
+void reset(MtList<T, N, A, B> &) noexcept {}
+#endif
+
+template <typename T, unsigned N, typename A, typename B>
+Spin snapshot(MtList<T, N, A, B> &q) noexcept {
+    Spin res = {0, 0, 0};
+    for (unsigned m = 0; m < N; ++m) {
+        Spin s = snapshot(q, m);
+        res.acquires += s.acquires;
+        res.spins += s.spins;
+        res.longest = s.longest > res.longest ? s.longest : res.longest;
+    }
+    return res;
+}
+
+// locks `ele`, an element of the `m` entry's segment, returning its link
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *lock(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele) noexcept {
+    Ele<T> *res;
+    size_t spin = 0;
+    while ((res = ele->next.exchange(ele, consume)) == ele) {
+        B::wait(ele->next, ele, spin++);
+    }
+    spinstat(q, m, spin);
+    return res;
+}
+// the link of `ele`, once it's unlocked, without locking it
+template <typename T, unsigned N, typename A, typename B>
+Ele<T> *peek(MtList<T, N, A, B> &, Ele<T> *ele) noexcept {
+    Ele<T> *res;
+    size_t spin = 0;
+    while ((res = ele->next.load(acquire)) == ele) {
+        B::wait(ele->next, ele, spin++);
+    }
+    return res;
+}
+// unlocks `ele`, setting its link to `next`
+template <typename T, unsigned N, typename A, typename B>
+void unlock(MtList<T, N, A, B> &, Ele<T> *ele, decltype(ele) next,
+            std::memory_order order) noexcept {
+    ele->next.store(next, order);
+    B::wake(ele->next);
+}
+// unlocks the `back` pointer of the `m` entry, setting it to `ele`
+template <typename T, unsigned N, typename A, typename B>
+void unback(MtList<T, N, A, B> &q, unsigned m, Ele<T> *ele,
+            std::memory_order order) noexcept {
+    q.back[m].store(ele, order);
+    B::wake(q.back[m]);
+}
+}
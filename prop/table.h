@@ -0,0 +1,278 @@
+namespace mtl {
+
+// concurrent hash table of `MtList` elements, grown by linear hashing: with
+// `n` buckets, `2^i <= n < 2^(i + 1)`, a hash goes to its bucket modulo
+// `2^(i + 1)`, or modulo `2^i` when that one isn't there yet, and a split
+// moves the elements of the bucket `n - 2^i` that belong to the bucket `n`.
+// The buckets are bare links, locked as the elements' ones, by pointing to
+// themselves, and kept in segments that never move, the `k`-th one holding
+// `2^(base + k - 1)` of them; the splitter keeps the split bucket locked until
+// it published the new count, so the operations waiting on it look for their
+// bucket again.
+// The helpers are kept in the `table` namespace, off the names of the other
+// containers.
+
+namespace table {
+template <typename T> using Link = std::atomic<Ele<T> *>;
+}
+
+template <typename T, typename H = std::hash<T>, typename E = std::equal_to<>,
+          typename A = Heap, typename B = Busy>
+struct Table {
+    static constexpr unsigned base = 6;
+    static constexpr size_t load = 2;
+    table::Link<T> *segs[64 - base];
+    table::Link<T> root[1 << base];
+    alignas(cacheln) std::atomic<size_t> buckets{1 << base};
+    alignas(cacheln) std::atomic<size_t> size{0};
+    alignas(cacheln) std::atomic<bool> splitting{false};
+    H hash;
+    E equal;
+    Table() noexcept {
+        for (auto &b : root) {
+            b.store(nullptr, relaxed);
+        }
+        segs[0] = root;
+        for (unsigned k = 1; k < 64 - base; ++k) {
+            segs[k] = nullptr;
+        }
+    }
+    // not concurrent with the other functions
+    ~Table() noexcept {
+        Ele<T> *next;
+        for (size_t b = 0; b < buckets.load(relaxed); ++b) {
+            for (Ele<T> *e = (*this)[b].load(relaxed); e; e = next) {
+                next = e->next.load(relaxed);
+                A::drop(e);
+            }
+        }
+        for (unsigned k = 1; k < 64 - base; ++k) {
+            delete[] segs[k];
+        }
+    }
+    table::Link<T> &operator[](const size_t b) noexcept {
+        unsigned p;
+        if (b < (size_t(1) << base)) {
+            return root[b];
+        }
+        p = 63 - __builtin_clzll(b);
+        return segs[p - base + 1][b - (size_t(1) << p)];
+    }
+};
+template <typename T, typename H, typename E, typename A, typename B,
+          typename... V>
+Ele<T> *make(Table<T, H, E, A, B> &, V &&... v) noexcept {
+    return A::template make<T>(std::forward<V>(v)...);
+}
+template <typename T, typename H, typename E, typename A, typename B>
+void drop(Table<T, H, E, A, B> &, Ele<T> *ele) noexcept {
+    A::drop(ele);
+}
+// locks the `link`, which points to `self` while it's locked
+template <typename T, typename H, typename E, typename A, typename B>
+Ele<T> *lock(Table<T, H, E, A, B> &, table::Link<T> &link,
+             Ele<T> *self) noexcept {
+    Ele<T> *res;
+    size_t spin = 0;
+    while ((res = link.exchange(self, consume)) == self) {
+        B::wait(link, self, spin++);
+    }
+    return res;
+}
+template <typename T, typename H, typename E, typename A, typename B>
+void unlock(Table<T, H, E, A, B> &, table::Link<T> &link,
+            typename table::Link<T>::value_type next,
+            std::memory_order order) noexcept {
+    link.store(next, order);
+    B::wake(link);
+}
+namespace table {
+template <typename T> Ele<T> *self(Link<T> &link) noexcept {
+    return reinterpret_cast<Ele<T> *>(&link);
+}
+// the bucket of the hash `h` with `n` buckets
+inline size_t bucket(const size_t h, const size_t n) noexcept {
+    unsigned i = 63 - __builtin_clzll(n);
+    size_t b = h & ((size_t(2) << i) - 1);
+    return b < n ? b : h & ((size_t(1) << i) - 1);
+}
+// walks the bucket of `key`, locked hand over hand, to the first element
+// equal to `key`, which is returned locked, with `next` its link, and `pred`
+// the link to it, locked too; if there's none, returns nullptr, `pred` being
+// the last link, locked
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K>
+Ele<T> *seek(Table<T, H, E, A, B> &t, const K &key, Link<T> *&pred,
+             Ele<T> *&next) noexcept {
+    size_t h = t.hash(key);
+    size_t n = t.buckets.load(acquire);
+    size_t b = bucket(h, n);
+    Ele<T> *curr;
+    do {
+        pred = &t[b];
+        curr = lock(t, *pred, self(*pred));
+        n = t.buckets.load(acquire);
+        if (likely(bucket(h, n) == b)) {
+            break;
+        }
+        unlock(t, *pred, curr, relaxed);
+        b = bucket(h, n);
+    } while (true);
+    while (curr != nullptr) {
+        next = lock(t, curr->next, curr);
+        if (t.equal(curr->data, key)) {
+            return curr;
+        }
+        unlock(t, *pred, curr, release);
+        pred = &curr->next;
+        curr = next;
+    }
+    return nullptr;
+}
+// splits the next bucket, returns false if its segment can't be allocated
+template <typename T, typename H, typename E, typename A, typename B>
+bool split(Table<T, H, E, A, B> &t) noexcept {
+    constexpr unsigned base = Table<T, H, E, A, B>::base;
+    size_t n = t.buckets.load(relaxed);
+    unsigned i = 63 - __builtin_clzll(n);
+    unsigned k = i - base + 1;
+    Link<T> *src = &t[n - (size_t(1) << i)];
+    Link<T> *pred = nullptr;
+    Ele<T> *keep = nullptr;
+    Ele<T> *head = nullptr;
+    Ele<T> *tail = nullptr;
+    Ele<T> *curr;
+    Ele<T> *next;
+    if (n == (size_t(1) << i) && t.segs[k] == nullptr) {
+        if ((t.segs[k] = new (std::nothrow) Link<T>[n]) == nullptr) {
+            return false;
+        }
+        for (size_t b = 0; b < n; ++b) {
+            t.segs[k][b].store(nullptr, relaxed);
+        }
+    }
+    curr = lock(t, *src, self(*src));
+    while (curr != nullptr) {
+        next = lock(t, curr->next, curr);
+        if ((t.hash(curr->data) & ((size_t(2) << i) - 1)) == n) {
+            if (tail != nullptr) {
+                tail->next.store(curr, relaxed);
+            } else {
+                head = curr;
+            }
+            tail = curr;
+        } else {
+            if (pred != nullptr) {
+                unlock(t, *pred, curr, release);
+            } else {
+                keep = curr;
+            }
+            pred = &curr->next;
+        }
+        curr = next;
+    }
+    if (pred != nullptr) {
+        unlock(t, *pred, nullptr, release);
+    }
+    if (tail != nullptr) {
+        tail->next.store(nullptr, relaxed);
+    }
+    t[n].store(head, relaxed);
+    t.buckets.store(n + 1, release);
+    unlock(t, *src, keep, release);
+    return true;
+}
+// ends the splits
+template <typename T, typename H, typename E, typename A, typename B>
+void unsplit(Table<T, H, E, A, B> &t) noexcept {
+    t.splitting.store(false, release);
+    B::wake(t.splitting);
+}
+// splits until the table isn't loaded, unless a split is running, which
+// catches up with the inserts made meanwhile
+template <typename T, typename H, typename E, typename A, typename B>
+void expand(Table<T, H, E, A, B> &t) noexcept {
+    constexpr size_t load = Table<T, H, E, A, B>::load;
+    auto loaded = [&] {
+        return t.size.load(relaxed) > load * t.buckets.load(relaxed);
+    };
+    if (!loaded() || t.splitting.load(relaxed) ||
+        t.splitting.exchange(true, acquire)) {
+        return;
+    }
+    while (loaded() && split(t)) {
+        continue;
+    }
+    unsplit(t);
+}
+}
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K, typename F>
+bool find(Table<T, H, E, A, B> &t, const K &key, F f) noexcept {
+    table::Link<T> *pred;
+    Ele<T> *next;
+    Ele<T> *curr = table::seek(t, key, pred, next);
+    if (curr == nullptr) {
+        unlock(t, *pred, nullptr, release);
+        return false;
+    }
+    f(curr->data);
+    unlock(t, curr->next, next, release);
+    unlock(t, *pred, curr, release);
+    return true;
+}
+template <typename T, typename H, typename E, typename A, typename B>
+bool insert(Table<T, H, E, A, B> &t, Ele<T> *ele) noexcept {
+    table::Link<T> *pred;
+    Ele<T> *next;
+    Ele<T> *curr = table::seek(t, ele->data, pred, next);
+    if (curr != nullptr) {
+        unlock(t, curr->next, next, release);
+        unlock(t, *pred, curr, release);
+        return false;
+    }
+    ele->next.store(nullptr, relaxed);
+    unlock(t, *pred, ele, release);
+    t.size.fetch_add(1, relaxed);
+    table::expand(t);
+    return true;
+}
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K>
+Ele<T> *take(Table<T, H, E, A, B> &t, const K &key) noexcept {
+    table::Link<T> *pred;
+    Ele<T> *next;
+    Ele<T> *curr = table::seek(t, key, pred, next);
+    if (curr == nullptr) {
+        unlock(t, *pred, nullptr, release);
+        return nullptr;
+    }
+    unlock(t, *pred, next, release);
+    curr->next.store(nullptr, relaxed);
+    t.size.fetch_sub(1, relaxed);
+    return curr;
+}
+template <typename T, typename H, typename E, typename A, typename B,
+          typename K>
+bool erase(Table<T, H, E, A, B> &t, const K &key) noexcept {
+    Ele<T> *ele = take(t, key);
+    if (ele == nullptr) {
+        return false;
+    }
+    drop(t, ele);
+    return true;
+}
+template <typename T, typename H, typename E, typename A, typename B>
+bool rehash(Table<T, H, E, A, B> &t, const size_t n) noexcept {
+    size_t spin = 0;
+    bool res = true;
+    while (t.splitting.exchange(true, acquire)) {
+        B::wait(t.splitting, true, spin++);
+    }
+    while (res && t.buckets.load(relaxed) < n) {
+        res = table::split(t);
+    }
+    table::unsplit(t);
+    return res;
+}
+}
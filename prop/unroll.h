@@ -0,0 +1,180 @@
+namespace mtl {
+
+// Unrolled list, every block holds up to `K` data, filling it from the end,
+// so that the data of a block are `data[K - count]` to `data[K - 1]`. The
+// link of each block is locked as the `Ele` one, pointing to its own block,
+// and it guards the data of the block it points to, the head's one guarding
+// the first block: pushing at the front takes a single lock, and traversals
+// lock a block every `K` data.
+// Blocks are only unlinked when they're emptied, by a traversal, which holds
+// the link pointing to them.
+
+template <typename T> constexpr unsigned fit(unsigned lines) noexcept {
+    constexpr size_t over = sizeof(void *) + sizeof(unsigned);
+    size_t k = (lines * cacheln - over) / sizeof(T);
+    return k > 0 ? k : 1;
+}
+
+template <typename T, unsigned K> struct alignas(cacheln) Block {
+    std::atomic<Block *> next;
+    unsigned count;
+    T data[K];
+    Block() noexcept : next{nullptr}, count{0} {
+        static_assert(std::is_nothrow_move_assignable<T>(),
+                      "move cannot throw");
+        static_assert(std::is_nothrow_default_constructible<T>(),
+                      "must be default constructable");
+    }
+};
+template <typename T, unsigned K = fit<T>(1), typename B = Busy>
+struct Unroll {
+    Block<T, K> head;
+};
+
+template <typename T, unsigned K, typename B>
+Block<T, K> *lock(Unroll<T, K, B> &, Block<T, K> *blk) noexcept {
+    Block<T, K> *res;
+    size_t spin = 0;
+    while ((res = blk->next.exchange(blk, consume)) == blk) {
+        B::wait(blk->next, blk, spin++);
+    }
+    return res;
+}
+template <typename T, unsigned K, typename B>
+void unlock(Unroll<T, K, B> &, Block<T, K> *blk, decltype(blk) next,
+            std::memory_order order) noexcept {
+    blk->next.store(next, order);
+    B::wake(blk->next);
+}
+template <typename T, unsigned K, typename B>
+void drop(Unroll<T, K, B> &, Block<T, K> *blk) noexcept {
+    delete blk;
+}
+
+template <typename T, unsigned K, typename B, typename V>
+bool push(Unroll<T, K, B> &u, V &&v) noexcept {
+    Block<T, K> *first = lock(u, &u.head);
+    if (first == nullptr || first->count == K) {
+        auto blk = new (std::nothrow) Block<T, K>;
+        if (unlikely(blk == nullptr)) {
+            unlock(u, &u.head, first, release);
+            return false;
+        }
+        blk->next.store(first, relaxed);
+        first = blk;
+    }
+    first->data[K - ++first->count] = std::forward<V>(v);
+    unlock(u, &u.head, first, release);
+    return true;
+}
+// the data are filtered in order, packing the kept ones at the start of the
+// block's range, then they're moved back to its end, and emptied blocks are
+// unlinked
+template <typename T, typename P, typename F, unsigned K, typename B>
+void trim(Unroll<T, K, B> &u, F filt, P pred, bool cont) noexcept {
+    Block<T, K> *prev = &u.head;
+    Block<T, K> *curr = lock(u, prev);
+    Block<T, K> *next;
+    bool found = false;
+    while (curr != nullptr) {
+        unsigned from = K - curr->count;
+        unsigned to = from;
+        for (unsigned i = from; i < K; ++i) {
+            if ((cont || !found) && filt(curr->data[i])) {
+                pred(curr->data[i]);
+                found = true;
+            } else if (to++ != i) {
+                curr->data[to - 1] = std::move(curr->data[i]);
+            }
+        }
+        if (to != K) {
+            for (unsigned i = to; i-- > from;) {
+                curr->data[K - to + i] = std::move(curr->data[i]);
+            }
+            curr->count = to - from;
+        }
+        if (curr->count == 0) {
+            next = lock(u, curr);
+            drop(u, curr);
+            curr = next;
+        } else if (cont || !found) {
+            next = lock(u, curr);
+            unlock(u, prev, curr, release);
+            prev = curr;
+            curr = next;
+        }
+        if (!cont && found) {
+            break;
+        }
+    }
+    unlock(u, prev, curr, release);
+}
+template <typename T, typename F, unsigned K, typename B>
+T get(Unroll<T, K, B> &u, F filt) noexcept {
+    T res = {};
+    trim(u, filt, [&](T &data) { res = std::move(data); }, false);
+    return res;
+}
+template <typename T, typename F, unsigned K, typename B>
+size_t rm(Unroll<T, K, B> &u, F filt) noexcept {
+    size_t n = 0;
+    trim(u, filt, [&](T &data) {
+        T tmp = std::move(data);
+        ++n;
+    });
+    return n;
+}
+// the matching data are moved in order in new blocks, on allocation failure
+// the rest is left in the list
+template <typename T, typename F, unsigned K, typename B>
+Block<T, K> *gather(Unroll<T, K, B> &u, F filt) noexcept {
+    Block<T, K> *head = nullptr;
+    Block<T, K> *last = nullptr;
+    bool full = false;
+    trim(u,
+         [&](const T &data) {
+             if (full || !filt(data)) {
+                 return false;
+             }
+             if (last != nullptr && last->count < K) {
+                 return true;
+             }
+             auto blk = new (std::nothrow) Block<T, K>;
+             if (unlikely(blk == nullptr)) {
+                 full = true;
+                 return false;
+             }
+             if (last == nullptr) {
+                 head = blk;
+             } else {
+                 last->next.store(blk, relaxed);
+             }
+             last = blk;
+             return true;
+         },
+         [&](T &data) { last->data[last->count++] = std::move(data); });
+    if (last != nullptr && last->count < K) {
+        for (unsigned i = last->count; i-- > 0;) {
+            last->data[K - last->count + i] = std::move(last->data[i]);
+        }
+    }
+    return head;
+}
+template <typename T, unsigned K, typename B>
+Block<T, K> *tail(Unroll<T, K, B> &u) noexcept {
+    Block<T, K> *head = lock(u, &u.head);
+    Block<T, K> *prev;
+    Block<T, K> *curr;
+    unlock(u, &u.head, nullptr, release);
+    if (head == nullptr) {
+        return nullptr;
+    }
+    prev = head;
+    while ((curr = lock(u, prev)) != nullptr) {
+        unlock(u, prev, curr, release);
+        prev = curr;
+    }
+    unlock(u, prev, nullptr, release);
+    return head;
+}
+}
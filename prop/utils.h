@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -8,15 +9,30 @@ namespace mtl {
 
 static constexpr auto cacheln = 64;
 static constexpr auto consume = std::memory_order_consume;
+static constexpr auto acquire = std::memory_order_acquire;
 static constexpr auto relaxed = std::memory_order_relaxed;
 static constexpr auto release = std::memory_order_release;
 
 #define unlikely(x) __builtin_expect(!!(x), 0)
 #define likely(x) __builtin_expect(!!(x), 1)
 
+// atomic alone in its cache line
+template <typename T> struct alignas(cacheln) Padded : std::atomic<T> {
+    using std::atomic<T>::operator=;
+};
+
+// spin loop hint, lets the sibling hyperthread run
+inline void relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
 template <typename T> void prefetch(T) {}
-template <typename T> void prefetch(T *x) { __buildin_prefetch(x); }
-template <typename T> void prefetch(const T *x) { __buildin_prefetch(x); }
+template <typename T> void prefetch(T *x) { __builtin_prefetch(x); }
+template <typename T> void prefetch(const T *x) { __builtin_prefetch(x); }
 template <typename T> void prefetch(std::vector<T> &x) {
     prefetch(x.data());
 }
@@ -0,0 +1,167 @@
+namespace mtl {
+
+// hashed hierarchical timer wheel over the multiple insertion points list,
+// `L` levels of `S` slots, a slot of the level `l` spanning `S^l` ticks, the
+// last entry holding the timers found due when armed; a timer is chained to
+// the level whose span fits its delay, in the slot its deadline hashes to,
+// and moves down a level each time `advance` reaches its slot, until it fires
+// from the level 0. The deadlines past the span of the wheel are put in its
+// last slot, and rearmed from there.
+// `now` is published before the slots of a tick are taken, so an `arm` which
+// reads it past its slot's tick after chaining takes the slot back and
+// rearms what it holds, instead of leaving the timer there for a rotation.
+// A timer has two references, the wheel's, given to the caller of `advance`
+// with the fired timers, and the handle's, given back by `cancel`, or by
+// `drop` when the handle isn't needed anymore; it's freed with the last one.
+
+template <typename T> struct Tick {
+    uint64_t at;
+    std::atomic<bool> dead;
+    std::atomic<unsigned> refs;
+    T data;
+    Tick() noexcept : at{0}, dead{false}, refs{0}, data{} {}
+    template <typename... V>
+    Tick(const uint64_t at, V &&... v) noexcept
+        : at{at}, dead{false}, refs{2}, data{std::forward<V>(v)...} {}
+    Tick(Tick &&other) noexcept
+        : at{other.at}, dead{other.dead.load(relaxed)},
+          refs{other.refs.load(relaxed)}, data{std::move(other.data)} {
+        static_assert(std::is_nothrow_move_constructible<T>(),
+                      "move cannot throw");
+    }
+};
+
+template <typename T, unsigned L = 4, unsigned S = 64, typename A = Heap,
+          typename B = Busy>
+struct Wheel {
+    static_assert(S > 1 && (S & (S - 1)) == 0, "must be a power of two");
+    static_assert(L > 0 && L * __builtin_ctz(S) < 64, "must fit 64 bits");
+    static constexpr unsigned bits = __builtin_ctz(S);
+    static constexpr unsigned due = L * S;
+    MtList<Tick<T>, L * S + 1, A, B> q;
+    alignas(cacheln) std::atomic<uint64_t> now{0};
+};
+template <typename T, unsigned L, unsigned S, typename A, typename B,
+          typename... V>
+Ele<Tick<T>> *make(Wheel<T, L, S, A, B> &w, const uint64_t at,
+                   V &&... v) noexcept {
+    return make(w.q, Tick<T>(at, std::forward<V>(v)...));
+}
+// gives back a reference
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void drop(Wheel<T, L, S, A, B> &w, Ele<Tick<T>> *ele) noexcept {
+    if (ele->data.refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        drop(w.q, ele);
+    }
+}
+// the entry of a timer due at `at`, past the `now` tick, and the tick at
+// which `advance` takes its slot
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+unsigned slot(Wheel<T, L, S, A, B> &, uint64_t at, const uint64_t now,
+              uint64_t &when) noexcept {
+    constexpr unsigned bits = Wheel<T, L, S, A, B>::bits;
+    constexpr uint64_t span = (uint64_t(1) << L * bits) - 1;
+    unsigned l = 0;
+    if (at - now > span) {
+        at = now + span;
+    }
+    while (l + 1 < L && at - now >= uint64_t(1) << (l + 1) * bits) {
+        ++l;
+    }
+    when = at >> l * bits << l * bits;
+    return l * S + ((at >> l * bits) & (S - 1));
+}
+// chains `ele`, returns its entry if `advance` might have taken it already,
+// the due entry otherwise
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+unsigned place(Wheel<T, L, S, A, B> &w, Ele<Tick<T>> *ele) noexcept {
+    constexpr unsigned due = Wheel<T, L, S, A, B>::due;
+    uint64_t now = w.now.load(acquire);
+    uint64_t when;
+    unsigned m;
+    if (ele->data.at <= now) {
+        chain(w.q, due, ele, ele);
+        return due;
+    }
+    m = slot(w, ele->data.at, now, when);
+    chain(w.q, m, ele, ele);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return w.now.load(relaxed) >= when ? m : due;
+}
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void rescue(Wheel<T, L, S, A, B> &w, const unsigned m) noexcept {
+    Ele<Tick<T>> *ele = chunk(w.q, m);
+    Ele<Tick<T>> *next;
+    for (; ele != nullptr; ele = next) {
+        next = ele->next.load(relaxed);
+        if (ele->data.dead.load(acquire)) {
+            drop(w, ele);
+        } else {
+            arm(w, ele);
+        }
+    }
+}
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void arm(Wheel<T, L, S, A, B> &w, Ele<Tick<T>> *ele) noexcept {
+    constexpr unsigned due = Wheel<T, L, S, A, B>::due;
+    unsigned m = place(w, ele);
+    if (unlikely(m != due)) {
+        rescue(w, m);
+    }
+}
+// gives back the handle's reference
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+bool cancel(Wheel<T, L, S, A, B> &w, Ele<Tick<T>> *ele) noexcept {
+    bool res = !ele->data.dead.exchange(true, std::memory_order_acq_rel);
+    drop(w, ele);
+    return res;
+}
+// takes the `m` entry's timers, appending the due ones to `head` and `tail`,
+// dropping the cancelled ones and rearming the others
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+void expire(Wheel<T, L, S, A, B> &w, const unsigned m, const uint64_t now,
+            Ele<Tick<T>> *&head, Ele<Tick<T>> *&tail) noexcept {
+    Ele<Tick<T>> *ele;
+    Ele<Tick<T>> *next;
+    if (w.q.entry[m].next.load(acquire) == bound(w.q, m)) {
+        return;
+    }
+    for (ele = chunk(w.q, m); ele != nullptr; ele = next) {
+        next = ele->next.load(relaxed);
+        if (ele->data.dead.load(acquire)) {
+            drop(w, ele);
+        } else if (ele->data.at > now) {
+            arm(w, ele);
+        } else if (ele->data.dead.exchange(true, std::memory_order_acq_rel)) {
+            drop(w, ele);
+        } else {
+            ele->next.store(nullptr, relaxed);
+            if (tail != nullptr) {
+                tail->next.store(ele, relaxed);
+            } else {
+                head = ele;
+            }
+            tail = ele;
+        }
+    }
+}
+template <typename T, unsigned L, unsigned S, typename A, typename B>
+Ele<Tick<T>> *advance(Wheel<T, L, S, A, B> &w, const uint64_t now) noexcept {
+    constexpr unsigned bits = Wheel<T, L, S, A, B>::bits;
+    Ele<Tick<T>> *head = nullptr;
+    Ele<Tick<T>> *tail = nullptr;
+    for (uint64_t t = w.now.load(relaxed) + 1; t <= now; ++t) {
+        w.now.store(t, relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (unsigned l = L - 1; l > 0; --l) {
+            if ((t & ((uint64_t(1) << l * bits) - 1)) == 0) {
+                expire(w, l * S + ((t >> l * bits) & (S - 1)), t, head,
+                       tail);
+            }
+        }
+        expire(w, t & (S - 1), t, head, tail);
+    }
+    expire(w, Wheel<T, L, S, A, B>::due, w.now.load(relaxed), head, tail);
+    return head;
+}
+}